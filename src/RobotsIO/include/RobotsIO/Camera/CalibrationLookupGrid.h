@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef ROBOTSIO_CALIBRATIONLOOKUPGRID_H
+#define ROBOTSIO_CALIBRATIONLOOKUPGRID_H
+
+#include <Eigen/Dense>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace RobotsIO {
+    namespace Camera {
+        class CalibrationLookupGrid;
+    }
+}
+
+
+/**
+ * Trilinear interpolation, over a regular grid defined on a bounded 3D input space, of a calibration model
+ * providing an se(3) correction (translational part followed by the rotational part).
+ *
+ * The model is evaluated on the nodes of the grid only when required, and the result is memoized.
+ * Inputs outside the bounds are forwarded to the model.
+ */
+class RobotsIO::Camera::CalibrationLookupGrid
+{
+public:
+    typedef Eigen::Matrix<double, 6, 1> Vector6d;
+
+    typedef std::function<Vector6d(const Eigen::Vector3d&)> Model;
+
+    /**
+     * Accuracy of the grid with respect to the model, evaluated on random inputs,
+     * and mean latency of a single prediction, in seconds.
+     */
+    struct Report
+    {
+        std::size_t samples = 0;
+
+        double max_translation_error = 0.0;
+
+        double mean_translation_error = 0.0;
+
+        double max_rotation_error = 0.0;
+
+        double mean_rotation_error = 0.0;
+
+        double model_latency = 0.0;
+
+        double grid_latency = 0.0;
+    };
+
+    /**
+     * The grid is used only if its errors on the validation samples are within the bounds, otherwise the model is always used.
+     */
+    CalibrationLookupGrid(const Model& model, const Eigen::Vector3d& lower_bounds, const Eigen::Vector3d& upper_bounds, const Eigen::Vector3i& resolution, const double& translation_error_bound, const double& rotation_error_bound, const std::size_t& validation_samples = 200);
+
+    Vector6d predict(const Eigen::Vector3d& input);
+
+    bool is_within_error_bounds() const;
+
+    Report report() const;
+
+private:
+    bool is_inside(const Eigen::Vector3d& input) const;
+
+    Vector6d interpolate(const Eigen::Vector3d& input);
+
+    const Vector6d& node(const int& i, const int& j, const int& k);
+
+    Report validate(const std::size_t& samples);
+
+    Model model_;
+
+    const Eigen::Vector3d lower_bounds_;
+
+    const Eigen::Vector3d upper_bounds_;
+
+    const Eigen::Vector3i resolution_;
+
+    Eigen::Vector3d step_;
+
+    /* Memoized values of the model on the nodes. */
+    std::vector<Vector6d, Eigen::aligned_allocator<Vector6d>> nodes_;
+
+    std::vector<bool> evaluated_;
+
+    bool within_error_bounds_ = false;
+
+    Report report_;
+
+    /**
+     * Log name to be used in messages printed by the class.
+     */
+
+    const std::string log_name_ = "CalibrationLookupGrid";
+};
+
+#endif /* ROBOTSIO_CALIBRATIONLOOKUPGRID_H */
@@ -17,7 +17,9 @@
 
 #include <cstdint>
 #include <fstream>
+#include <functional>
 #include <string>
+#include <tuple>
 
 namespace RobotsIO {
     namespace Camera {
@@ -29,6 +31,38 @@ namespace RobotsIO {
 class RobotsIO::Camera::Camera
 {
 public:
+    /**
+     * RGB-D, pose and auxiliary data acquired together.
+     */
+    struct Frame
+    {
+        cv::Mat rgb;
+
+        /* Empty if not requested. */
+        Eigen::MatrixXf depth;
+
+        Eigen::Transform<double, 3, Eigen::Affine> pose;
+
+        /* Empty if not available. */
+        Eigen::VectorXd auxiliary_data;
+
+        /* Increasing for each acquired frame, or the frame index for offline playback. */
+        std::uint64_t sequence = 0;
+
+        /* Capture timestamps, if available. */
+        bool valid_rgb_timestamp = false;
+
+        double rgb_timestamp = 0.0;
+
+        bool valid_depth_timestamp = false;
+
+        double depth_timestamp = 0.0;
+
+        bool valid_pose_timestamp = false;
+
+        double pose_timestamp = 0.0;
+    };
+
     Camera();
 
     virtual ~Camera();
@@ -51,12 +85,50 @@ public:
 
     virtual std::pair<bool, Eigen::MatrixXf> depth(const bool& blocking) = 0;
 
-    virtual std::pair<bool, Eigen::MatrixXd> point_cloud(const bool& blocking, const double& maximum_depth = std::numeric_limits<double>::infinity(), const bool& use_root_frame = false, const bool& enable_colors = false);
+    /**
+     * Overloads writing into caller-provided outputs, whose storage is reused if they already have the required size.
+     * The default implementations forward to the overloads returning the outputs by value.
+     */
+
+    virtual bool depth(const bool& blocking, Eigen::MatrixXf& depth);
+
+    virtual bool depth_with_confidence(const bool& blocking, Eigen::MatrixXf& depth, Eigen::MatrixXf& confidence);
+
+    virtual bool rgb(const bool& blocking, cv::Mat& rgb);
+
+    /**
+     * Depth together with a per-pixel confidence map having the same size of the depth (1 for reliable pixels, 0 otherwise).
+     * The default implementation returns an empty confidence map, meaning that the camera does not provide one.
+     */
+    virtual std::tuple<bool, Eigen::MatrixXf, Eigen::MatrixXf> depth_with_confidence(const bool& blocking);
+
+    virtual std::pair<bool, Eigen::MatrixXd> point_cloud(const bool& blocking, const double& maximum_depth = std::numeric_limits<double>::infinity(), const bool& use_root_frame = false, const bool& enable_colors = false, const bool& use_confidence = false);
+
+    /**
+     * Point cloud stored in the first columns of the provided output, which is resized only if required,
+     * together with the number of points. Internal buffers are reused across calls such that, in steady state,
+     * point_cloud() does not allocate by itself, while the acquisition of rgb, depth and pose may, depending on the camera.
+     */
+    virtual std::pair<bool, std::size_t> point_cloud(const bool& blocking, Eigen::MatrixXd& cloud, const double& maximum_depth = std::numeric_limits<double>::infinity(), const bool& use_root_frame = false, const bool& enable_colors = false, const bool& use_confidence = false);
 
     virtual std::pair<bool, Eigen::Transform<double, 3, Eigen::Affine>> pose(const bool& blocking) = 0;
 
     virtual std::pair<bool, cv::Mat> rgb(const bool& blocking) = 0;
 
+    /**
+     * RGB, depth (if requested), pose and auxiliary data in a single call. The frame is valid if rgb, depth and pose are.
+     * The default implementation calls rgb(), depth(), pose() and auxiliary_data(), in this order, and does not provide timestamps.
+     */
+    virtual std::pair<bool, Frame> frame(const bool& blocking, const bool& enable_depth = true);
+
+    /**
+     * Listener invoked, on an internal thread, as soon as a new frame is received (see CameraEventLoop).
+     * An empty listener disables it and, once this returns, the previous listener is not running and is not invoked anymore.
+     * Cameras may change how frames are acquired in order to support it, e.g. by grabbing frames in the background.
+     * The default implementation returns false, meaning that the camera does not support it.
+     */
+    virtual bool set_frame_listener(const std::function<void()>& listener);
+
     /**
      * Auxiliary data.
      */
@@ -104,6 +176,36 @@ protected:
 
     bool deprojection_matrix_initialized_ = false;
 
+    /**
+     * Buffers reused by point_cloud().
+     */
+
+    cv::Mat point_cloud_rgb_;
+
+    Eigen::MatrixXf point_cloud_depth_;
+
+    Eigen::MatrixXf point_cloud_confidence_;
+
+    Eigen::MatrixXi point_cloud_valid_points_;
+
+    Eigen::MatrixXd point_cloud_deprojection_matrix_;
+
+    /**
+     * Acquisition of the data required by point_cloud() into the buffers above and, if required, of the camera pose.
+     * The default implementation calls rgb() (if required), depth() or depth_with_confidence() and pose() (if required), in this order.
+     * Cameras providing them together should override it, such that the data refer to the same frame.
+     */
+    virtual bool point_cloud_data(const bool& blocking, const bool& use_root_frame, const bool& enable_colors, const bool& use_confidence, Eigen::Transform<double, 3, Eigen::Affine>& camera_pose);
+
+    /**
+     * Steps of point_cloud(), i.e. acquisition of the data and search of the valid points, whose number is returned,
+     * and storage of the points in the first columns of the output, which should be large enough.
+     */
+
+    std::pair<bool, std::size_t> point_cloud_valid_points(const bool& blocking, const double& maximum_depth, const bool& use_root_frame, const bool& enable_colors, const bool& use_confidence, Eigen::Transform<double, 3, Eigen::Affine>& camera_pose);
+
+    void point_cloud_fill(Eigen::MatrixXd& cloud, const Eigen::Transform<double, 3, Eigen::Affine>& camera_pose, const bool& use_root_frame, const bool& enable_colors);
+
     /**
      * Constructor for offline playback.
      */
@@ -115,6 +217,11 @@ protected:
 
     virtual std::pair<bool, Eigen::MatrixXf> depth_offline();
 
+    /**
+     * Overload writing into a caller-provided output, whose storage is reused if it already has the required size.
+     */
+    bool depth_offline(Eigen::MatrixXf& depth);
+
     virtual std::pair<bool, Eigen::Transform<double, 3, Eigen::Affine>> pose_offline();
 
     virtual std::pair<bool, cv::Mat> rgb_offline();
@@ -141,6 +248,10 @@ protected:
 
     std::int32_t frame_index_ = -1;
 
+    std::uint64_t frame_sequence_ = 0;
+
+    Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> depth_offline_buffer_;
+
     static constexpr std::size_t standard_data_offset_ = 8;
 
     /*
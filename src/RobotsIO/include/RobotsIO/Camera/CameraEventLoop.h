@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef ROBOTSIO_CAMERAEVENTLOOP_H
+#define ROBOTSIO_CAMERAEVENTLOOP_H
+
+#include <RobotsIO/Camera/Camera.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace RobotsIO {
+    namespace Camera {
+        class CameraEventLoop;
+    }
+}
+
+
+/**
+ * Event-driven acquisition of the frames of a camera.
+ *
+ * Frames are acquired on an internal thread and delivered to the registered callbacks, which run on that thread,
+ * and to the futures returned by next_frame(). Frames are acquired only if there is someone waiting for them.
+ *
+ * For online cameras, the thread is woken up by the camera as soon as a new image is received
+ * (see Camera::set_frame_listener()). For offline playback, the thread steps through the frames
+ * and always keeps the next frame ready in advance.
+ *
+ * While the loop is running, the camera should not be used for acquisition from other threads.
+ *
+ * Exceptions thrown by the camera or by the callbacks are caught on the internal thread and counted as failures,
+ * such that the loop keeps running. A frame whose acquisition threw is not delivered.
+ */
+class RobotsIO::Camera::CameraEventLoop
+{
+public:
+    typedef std::shared_ptr<const RobotsIO::Camera::Camera::Frame> FrameHandle;
+
+    typedef std::function<void(const FrameHandle&)> Callback;
+
+    /**
+     * Frames are acquired using Camera::frame(). If the depth is enabled, frames are delivered only if the depth is available,
+     * hence it should be enabled only for cameras providing it, otherwise all the frames are dropped.
+     */
+    CameraEventLoop(RobotsIO::Camera::Camera& camera, const bool& enable_depth = false);
+
+    virtual ~CameraEventLoop();
+
+    std::size_t add_callback(const Callback& callback);
+
+    bool remove_callback(const std::size_t& id);
+
+    /**
+     * The next frame acquired, i.e. received after the request if no one else is waiting for frames.
+     * The handle is empty if the loop stops, e.g. at the end of the offline data, before a frame is available.
+     */
+    std::future<FrameHandle> next_frame();
+
+    /**
+     * Number of exceptions caught while acquiring the frames or invoking the callbacks.
+     */
+    std::uint64_t number_failures() const;
+
+    void stop();
+
+    bool is_running() const;
+
+private:
+    void run();
+
+    void run_offline();
+
+    bool has_demand() const;
+
+    void dispatch(const FrameHandle& frame);
+
+    void notify_frame_received();
+
+    /* Requires the mutex to be locked. */
+    void on_new_demand();
+
+    void report_failure(const std::string& method, const std::string& what);
+
+    RobotsIO::Camera::Camera& camera_;
+
+    const bool enable_depth_;
+
+    /* Protected by the mutex. */
+    std::map<std::size_t, Callback> callbacks_;
+
+    std::size_t next_callback_id_ = 0;
+
+    std::vector<std::promise<FrameHandle>> promises_;
+
+    bool running_ = true;
+
+    bool frame_received_ = false;
+
+    std::atomic<std::uint64_t> failures_;
+
+    mutable std::mutex mutex_;
+
+    std::condition_variable condition_;
+
+    std::thread thread_;
+
+    const std::string log_name_ = "CameraEventLoop";
+};
+
+#endif /* ROBOTSIO_CAMERAEVENTLOOP_H */
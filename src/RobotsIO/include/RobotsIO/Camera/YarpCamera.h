@@ -9,11 +9,17 @@
 #define ROBOTSIO_YARPCAMERA_H
 
 #include <RobotsIO/Camera/Camera.h>
+#include <RobotsIO/Utils/BufferPool.hpp>
+#include <RobotsIO/Utils/YarpFrameGrabber.hpp>
+#include <RobotsIO/Utils/YarpImageConversion.h>
+#include <RobotsIO/Utils/YarpPoseStream.h>
 
 #include <Eigen/Dense>
 
 #include <opencv2/opencv.hpp>
 
+#include <cstdint>
+#include <memory>
 #include <string>
 
 #include <yarp/os/BufferedPort.h>
@@ -44,8 +50,51 @@ public:
 
     std::pair<bool, cv::Mat> rgb(const bool& blocking) override;
 
+    std::pair<bool, RobotsIO::Camera::Camera::Frame> frame(const bool& blocking, const bool& enable_depth = true) override;
+
+    /**
+     * Setting a listener enables background frame grabbing (see enable_frame_grabbing()), which stays enabled
+     * after the listener is removed. Hence, rgb() and depth() then return the newest grabbed frames.
+     */
+    bool set_frame_listener(const std::function<void()>& listener) override;
+
     std::pair<bool, Eigen::MatrixXf> depth(const bool& blocking) override;
 
+    bool depth(const bool& blocking, Eigen::MatrixXf& depth) override;
+
+    using RobotsIO::Camera::Camera::rgb;
+
+    /**
+     * Frames are stored in pooled, reference counted buffers that are valid, and not modified, as long as they are referenced.
+     * The images returned by rgb() share the memory of their buffer, while depth() copies grabbed frames
+     * and otherwise converts the image straight into its output, without using the pool.
+     * Reading images from the ports, rather than from the grabbers, may still allocate.
+     */
+    std::pair<bool, std::shared_ptr<const Eigen::MatrixXf>> depth_buffer(const bool& blocking);
+
+    /**
+     * Background frame grabbing.
+     *
+     * Once enabled, frames are received as soon as they arrive and rgb() and depth() return the newest ones:
+     * a non-blocking call returns the newest frame without waiting, while a blocking call waits for a frame
+     * newer than the one previously returned.
+     */
+    bool enable_frame_grabbing();
+
+    /**
+     * Pose stream.
+     *
+     * Once enabled, poses are received on the port /<port_prefix>/pose:i, in the x-y-z-axis-angle format,
+     * and pose() returns the pose interpolated at the timestamp of the last image returned by rgb()
+     * (or the newest pose if not available). Otherwise, pose() returns the identity.
+     */
+    bool enable_pose_stream(const std::size_t& history_size = 64);
+
+    /**
+     * Timestamp of the last image returned by rgb(), taken from the envelope of the input port.
+     */
+    std::pair<bool, double> rgb_timestamp() const;
+
 private:
     yarp::os::Network yarp_;
 
@@ -55,8 +104,46 @@ private:
 
     yarp::os::BufferedPort<yarp::sig::ImageOf<yarp::sig::PixelFloat>> port_depth_;
 
+    yarp::sig::ImageOf<yarp::sig::PixelFloat>* read_depth(const bool& blocking);
+
     yarp::os::BufferedPort<yarp::sig::ImageOf<yarp::sig::PixelRgb>> port_rgb_;
 
+    std::string port_prefix_;
+
+    bool valid_rgb_timestamp_ = false;
+
+    double rgb_timestamp_ = 0.0;
+
+    bool valid_depth_timestamp_ = false;
+
+    double depth_timestamp_ = 0.0;
+
+    /**
+     * Pose source.
+     */
+
+    std::unique_ptr<RobotsIO::Utils::YarpPoseStream> pose_stream_;
+
+    /**
+     * Frame grabbers.
+     */
+
+    std::unique_ptr<RobotsIO::Utils::YarpFrameGrabber<yarp::sig::ImageOf<yarp::sig::PixelFloat>, Eigen::MatrixXf>> depth_grabber_;
+
+    std::unique_ptr<RobotsIO::Utils::YarpFrameGrabber<yarp::sig::ImageOf<yarp::sig::PixelRgb>, cv::Mat>> rgb_grabber_;
+
+    std::uint64_t depth_sequence_ = 0;
+
+    std::uint64_t rgb_sequence_ = 0;
+
+    /**
+     * Buffers for frames read without grabbers, using rgb() or depth_buffer().
+     */
+
+    RobotsIO::Utils::BufferPool<Eigen::MatrixXf> depth_pool_;
+
+    RobotsIO::Utils::BufferPool<cv::Mat> rgb_pool_{RobotsIO::Utils::is_mat_shared};
+
     /**
      * Log name to be used in messages printed by the class.
      */
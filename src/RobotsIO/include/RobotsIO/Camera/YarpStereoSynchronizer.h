@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef ROBOTSIO_YARPSTEREOSYNCHRONIZER_H
+#define ROBOTSIO_YARPSTEREOSYNCHRONIZER_H
+
+#include <RobotsIO/Utils/BufferPool.hpp>
+#include <RobotsIO/Utils/YarpImageConversion.h>
+
+#include <opencv2/opencv.hpp>
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <yarp/os/BufferedPort.h>
+#include <yarp/os/Network.h>
+#include <yarp/os/TypedReaderCallback.h>
+#include <yarp/sig/Image.h>
+
+namespace RobotsIO {
+    namespace Camera {
+        class YarpStereoSynchronizer;
+    }
+}
+
+
+/**
+ * Pairs left and right images received on two YARP ports using the timestamps in their envelopes.
+ *
+ * Images are stored, as soon as they arrive, in a small ring buffer per port such that pairing never waits
+ * on a blocking read of the slower port. Images not having a timestamp are stamped with their arrival time.
+ */
+class RobotsIO::Camera::YarpStereoSynchronizer
+{
+public:
+    struct StereoPair
+    {
+        cv::Mat left;
+
+        cv::Mat right;
+
+        double left_timestamp;
+
+        double right_timestamp;
+    };
+
+    struct Statistics
+    {
+        std::size_t pairs = 0;
+
+        /* Images discarded because of ring buffer overflow or because older than the last delivered pair. */
+        std::size_t dropped_left = 0;
+
+        std::size_t dropped_right = 0;
+
+        /* Time elapsed from the arrival of the newest image of a pair to its delivery, in seconds. */
+        double last_latency = 0.0;
+
+        double mean_latency = 0.0;
+
+        /* Absolute difference between the timestamps of the last delivered pair, in seconds. */
+        double last_skew = 0.0;
+    };
+
+    YarpStereoSynchronizer(const std::string& port_prefix, const double& tolerance, const std::size_t& buffer_size = 4);
+
+    ~YarpStereoSynchronizer();
+
+    /**
+     * The most recent pair whose timestamps differ at most by the tolerance.
+     *
+     * Images are taken from pools of buffers that are not recycled while referenced,
+     * hence they are never overwritten by the following pairs.
+     */
+    std::pair<bool, StereoPair> pair(const bool& blocking);
+
+    Statistics statistics() const;
+
+private:
+    struct StampedImage
+    {
+        yarp::sig::ImageOf<yarp::sig::PixelRgb> image;
+
+        double timestamp;
+
+        double arrival_time;
+    };
+
+    class ImageRing : public yarp::os::TypedReaderCallback<yarp::sig::ImageOf<yarp::sig::PixelRgb>>
+    {
+    public:
+        ImageRing(RobotsIO::Camera::YarpStereoSynchronizer& synchronizer, const std::size_t& size);
+
+        using yarp::os::TypedReaderCallback<yarp::sig::ImageOf<yarp::sig::PixelRgb>>::onRead;
+
+        void onRead(yarp::sig::ImageOf<yarp::sig::PixelRgb>& image) override;
+
+        StampedImage& at(const std::size_t& index);
+
+        void pop_front(const std::size_t& number);
+
+        std::size_t size() const;
+
+        yarp::os::BufferedPort<yarp::sig::ImageOf<yarp::sig::PixelRgb>> port;
+
+        std::size_t dropped = 0;
+
+    private:
+        RobotsIO::Camera::YarpStereoSynchronizer& synchronizer_;
+
+        std::vector<StampedImage> slots_;
+
+        std::size_t head_ = 0;
+
+        std::size_t count_ = 0;
+    };
+
+    bool find_pair(std::size_t& index_left, std::size_t& index_right);
+
+    yarp::os::Network yarp_;
+
+    const double tolerance_;
+
+    mutable std::mutex mutex_;
+
+    std::condition_variable image_received_;
+
+    ImageRing left_;
+
+    ImageRing right_;
+
+    RobotsIO::Utils::BufferPool<cv::Mat> left_pool_{RobotsIO::Utils::is_mat_shared};
+
+    RobotsIO::Utils::BufferPool<cv::Mat> right_pool_{RobotsIO::Utils::is_mat_shared};
+
+    Statistics statistics_;
+
+    /**
+     * Log name to be used in messages printed by the class.
+     */
+
+    const std::string log_name_ = "YarpStereoSynchronizer";
+};
+
+#endif /* ROBOTSIO_YARPSTEREOSYNCHRONIZER_H */
@@ -8,19 +8,26 @@
 #ifndef ROBOTSIO_ICUBCAMERA_H
 #define ROBOTSIO_ICUBCAMERA_H
 
+#include <RobotsIO/Camera/CalibrationLookupGrid.h>
 #include <RobotsIO/Camera/Camera.h>
+#include <RobotsIO/Camera/iCubEyeKinematics.h>
+#include <RobotsIO/Utils/BufferPool.hpp>
+#include <RobotsIO/Utils/YarpEncodersPoller.h>
+#include <RobotsIO/Utils/YarpFrameGrabber.hpp>
+#include <RobotsIO/Utils/YarpImageConversion.h>
 
 #include <Eigen/Dense>
 
-#include <iCub/iKin/iKinFwd.h>
 #include <iCub/learningMachine/LSSVMLearner.h>
 
 #include <opencv2/opencv.hpp>
 
+#include <cstdint>
+#include <memory>
 #include <string>
 
 #include <yarp/dev/GazeControl.h>
-#include <yarp/dev/IEncoders.h>
+#include <yarp/dev/IEncodersTimed.h>
 #include <yarp/dev/PolyDriver.h>
 #include <yarp/os/Bottle.h>
 #include <yarp/os/BufferedPort.h>
@@ -37,6 +44,26 @@ namespace RobotsIO {
 class RobotsIO::Camera::iCubCamera : public RobotsIO::Camera::Camera
 {
 public:
+    /**
+     * Torso (3) and head (6) encoders, in degrees, read once per frame.
+     *
+     * Fixed-size, unaligned, storage is used such that snapshots can be copied without allocations.
+     */
+    struct EncodersSnapshot
+    {
+        bool valid_torso = false;
+
+        Eigen::Matrix<double, 3, 1, Eigen::DontAlign> torso;
+
+        bool valid_head = false;
+
+        Eigen::Matrix<double, 6, 1, Eigen::DontAlign> head;
+
+        /* Most recent among the timestamps of the encoders, if available. */
+        bool valid_timestamp = false;
+
+        double timestamp = 0.0;
+    };
 
     iCubCamera(const std::string& robot_name, const std::string& laterality, const std::string& port_prefix, const std::string& fallback_context_name, const std::string& fallback_configuration_name, const bool& use_calibration = false, const std::string& calibration_path = "");
 
@@ -54,10 +81,84 @@ public:
 
     std::pair<bool, Eigen::MatrixXf> depth(const bool& blocking) override;
 
+    bool depth(const bool& blocking, Eigen::MatrixXf& depth) override;
+
+    using RobotsIO::Camera::Camera::rgb;
+
     std::pair<bool, Eigen::Transform<double, 3, Eigen::Affine>> pose(const bool& blocking) override;
 
     std::pair<bool, cv::Mat> rgb(const bool& blocking) override;
 
+    std::pair<bool, RobotsIO::Camera::Camera::Frame> frame(const bool& blocking, const bool& enable_depth = true) override;
+
+    /**
+     * Setting a listener enables background frame grabbing (see enable_frame_grabbing()), which stays enabled
+     * after the listener is removed. Hence, rgb() and depth() then return the newest grabbed frames.
+     */
+    bool set_frame_listener(const std::function<void()>& listener) override;
+
+    /**
+     * Frames are stored in pooled, reference counted buffers that are valid, and not modified, as long as they are referenced.
+     * The images returned by rgb() share the memory of their buffer, while depth() copies grabbed frames
+     * and otherwise converts the image straight into its output, without using the pool.
+     */
+    std::pair<bool, std::shared_ptr<const Eigen::MatrixXf>> depth_buffer(const bool& blocking);
+
+    /**
+     * Pose evaluated, including the calibration if requested, using the provided encoders
+     * (ignored for the kinematics if the pose is taken from the gaze controller or from the offline data).
+     */
+    std::pair<bool, Eigen::Transform<double, 3, Eigen::Affine>> pose_from_encoders(const EncodersSnapshot& snapshot);
+
+    /**
+     * Background frame grabbing.
+     *
+     * Once enabled, frames are received as soon as they arrive and rgb() and depth() return the newest ones:
+     * a non-blocking call returns the newest frame without waiting, while a blocking call waits for a frame
+     * newer than the one previously returned.
+     */
+    bool enable_frame_grabbing();
+
+    /**
+     * Background encoders polling.
+     *
+     * Once enabled, encoders are sampled by a separate thread and pose() is evaluated using the encoders
+     * interpolated at the timestamp of the last image returned by rgb() (or the newest encoders if not available).
+     */
+
+    bool enable_encoders_polling(const double& period, const std::size_t& history_size = 256);
+
+    std::pair<bool, Eigen::Transform<double, 3, Eigen::Affine>> pose_at(const double& timestamp);
+
+    /**
+     * Lookup grid for the calibration model of the right eye.
+     *
+     * The model is interpolated over a grid defined on the eyes encoders (tilt, version and vergence, in degrees),
+     * within the given bounds. The grid is used only if its errors, with respect to the model, are within the given bounds
+     * (in meters and radians). The returned report contains the errors and the latency of a single prediction.
+     */
+    std::pair<bool, RobotsIO::Camera::CalibrationLookupGrid::Report> enable_calibration_lookup(const Eigen::Vector3d& lower_bounds, const Eigen::Vector3d& upper_bounds, const Eigen::Vector3i& resolution, const double& translation_error_bound, const double& rotation_error_bound);
+
+    /**
+     * Offline poses.
+     *
+     * Poses of all the frames, as stored in the offline data (raw) and including the calibration if requested (calibrated),
+     * evaluated in parallel and stored as 7 x N matrices (position and axis-angle, as in the offline data).
+     * Once evaluated, pose() retrieves the calibrated pose of the current frame.
+     *
+     * If persistence is requested, the poses are loaded from the file poses_<laterality>.double within the data path,
+     * if available, and saved to it otherwise (the file should be removed if the calibration model changes).
+     */
+
+    bool evaluate_offline_poses(const bool& use_persistence = false);
+
+    std::pair<bool, Eigen::MatrixXd> offline_poses(const bool& calibrated) const;
+
+    /**
+     * Timestamp of the last image returned by rgb(), taken from the envelope of the input port.
+     */
+    std::pair<bool, double> rgb_timestamp() const;
+
     /**
      * Auxiliary data.
      */
@@ -69,10 +170,36 @@ public:
 protected:
     std::string laterality();
 
-    std::pair<bool, Eigen::Transform<double, 3, Eigen::Affine>> laterality_pose(const std::string& laterality, const bool& blocking);
+    std::pair<bool, Eigen::Transform<double, 3, Eigen::Affine>> laterality_pose(const std::string& laterality, const EncodersSnapshot& snapshot);
 
     void set_laterality(const std::string& laterality);
 
+    /**
+     * Encoders snapshot.
+     *
+     * The encoders are read again only when the caller requests a snapshot it has already consumed,
+     * e.g. pose() and auxiliary_data() called once each, in any order, share the same snapshot.
+     */
+
+    std::pair<bool, EncodersSnapshot> acquire_encoders_snapshot(bool& consumed);
+
+    /**
+     * Snapshot read again regardless of the consumers, with the polled encoders, if enabled, evaluated at the given timestamp
+     * instead of the one of the last image returned by rgb(), e.g. for images received through other ports.
+     */
+    std::pair<bool, EncodersSnapshot> acquire_encoders_snapshot_at(const double& timestamp, bool& consumed);
+
+    /**
+     * Timestamp of the current snapshot, valid only if the pose is evaluated from the encoders and the snapshot is timestamped.
+     */
+    std::pair<bool, double> encoders_snapshot_timestamp() const;
+
+    bool requires_encoders() const;
+
+    bool pose_snapshot_consumed_ = true;
+
+    bool auxiliary_snapshot_consumed_ = true;
+
 private:
     std::string laterality_;
 
@@ -84,8 +211,38 @@ private:
 
     yarp::os::BufferedPort<yarp::sig::ImageOf<yarp::sig::PixelFloat>> port_depth_;
 
+    yarp::sig::ImageOf<yarp::sig::PixelFloat>* read_depth(const bool& blocking);
+
     yarp::os::BufferedPort<yarp::sig::ImageOf<yarp::sig::PixelRgb>> port_rgb_;
 
+    bool valid_rgb_timestamp_ = false;
+
+    double rgb_timestamp_ = 0.0;
+
+    bool valid_depth_timestamp_ = false;
+
+    double depth_timestamp_ = 0.0;
+
+    /**
+     * Frame grabbers.
+     */
+
+    std::unique_ptr<RobotsIO::Utils::YarpFrameGrabber<yarp::sig::ImageOf<yarp::sig::PixelFloat>, Eigen::MatrixXf>> depth_grabber_;
+
+    std::unique_ptr<RobotsIO::Utils::YarpFrameGrabber<yarp::sig::ImageOf<yarp::sig::PixelRgb>, cv::Mat>> rgb_grabber_;
+
+    std::uint64_t depth_sequence_ = 0;
+
+    std::uint64_t rgb_sequence_ = 0;
+
+    /**
+     * Buffers for frames read without grabbers, using rgb() or depth_buffer().
+     */
+
+    RobotsIO::Utils::BufferPool<Eigen::MatrixXf> depth_pool_;
+
+    RobotsIO::Utils::BufferPool<cv::Mat> rgb_pool_{RobotsIO::Utils::is_mat_shared};
+
     /**
      * Drivers.
      */
@@ -95,7 +252,7 @@ private:
 
     yarp::dev::PolyDriver driver_gaze_;
 
-    yarp::dev::IGazeControl* gaze_control_;
+    yarp::dev::IGazeControl* gaze_control_ = nullptr;
 
     bool use_driver_gaze_ = true;
 
@@ -105,15 +262,33 @@ private:
 
     yarp::dev::PolyDriver drv_torso_;
 
-    yarp::dev::IEncoders *itorso_;
+    yarp::dev::IEncodersTimed *itorso_ = nullptr;
 
     yarp::dev::PolyDriver drv_head_;
 
-    yarp::dev::IEncoders *ihead_;
+    yarp::dev::IEncodersTimed *ihead_ = nullptr;
+
+    /*
+     * Encoders snapshot.
+     */
+
+    bool refresh_encoders_snapshot(const bool& use_timestamp, const double& timestamp);
+
+    std::pair<bool, EncodersSnapshot> read_encoders_snapshot(const bool& use_timestamp, const double& timestamp);
+
+    std::pair<bool, EncodersSnapshot> polled_encoders_snapshot(const bool& use_timestamp, const double& timestamp);
+
+    std::unique_ptr<RobotsIO::Utils::YarpEncodersPoller> encoders_poller_;
 
-    iCub::iKin::iCubEye left_eye_kinematics_;
+    Eigen::VectorXd polled_encoders_;
 
-    iCub::iKin::iCubEye right_eye_kinematics_;
+    bool valid_snapshot_ = false;
+
+    EncodersSnapshot snapshot_;
+
+    std::unique_ptr<RobotsIO::Camera::iCubEyeKinematics> left_eye_kinematics_;
+
+    std::unique_ptr<RobotsIO::Camera::iCubEyeKinematics> right_eye_kinematics_;
 
     /*
      * Extrinsic calibration.
@@ -123,16 +298,30 @@ private:
 
     bool load_calibration_model(const std::string& model_path);
 
+    RobotsIO::Camera::CalibrationLookupGrid::Vector6d calibration_prediction(const Eigen::Vector3d& input);
+
+    RobotsIO::Camera::CalibrationLookupGrid::Vector6d calibration_model_prediction(const Eigen::Vector3d& input);
+
     bool use_calibration_ = false;
 
     iCub::learningmachine::LSSVMLearner calibration_;
 
+    std::unique_ptr<RobotsIO::Camera::CalibrationLookupGrid> calibration_grid_;
+
     /*
      * Offline playback.
      */
 
     bool load_encoders_data_ = false;
 
+    bool load_offline_poses(const std::string& file_name);
+
+    bool save_offline_poses(const std::string& file_name) const;
+
+    Eigen::MatrixXd offline_poses_raw_;
+
+    Eigen::MatrixXd offline_poses_calibrated_;
+
     /**
      * Log name to be used in messages printed by the class.
      */
@@ -9,12 +9,16 @@
 #define ROBOTSIO_ICUBCAMERADEPTH_H
 
 #include <RobotsIO/Camera/iCubCameraRelative.h>
+#include <RobotsIO/Utils/BufferPool.hpp>
 
 #include <Eigen/Dense>
 
 #include <opencv2/opencv.hpp>
 
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <tuple>
 
 namespace RobotsIO {
     namespace Camera {
@@ -26,6 +30,37 @@ namespace RobotsIO {
 class RobotsIO::Camera::iCubCameraDepth : public RobotsIO::Camera::iCubCameraRelative
 {
 public:
+    /**
+     * Immutable bundle produced by a single grab of the stereo pair.
+     *
+     * Images are taken from pools of buffers that are not recycled while referenced,
+     * hence a frame stays valid, and unchanged, as long as it is held.
+     */
+    struct StereoFrame
+    {
+        cv::Mat left;
+
+        cv::Mat right;
+
+        /* Pose of the right camera expressed in the left camera frame. */
+        Eigen::Transform<double, 3, Eigen::Affine> extrinsics;
+
+        /* Pose of the left camera. */
+        Eigen::Transform<double, 3, Eigen::Affine> pose;
+
+        /* Timestamp of the left image, if available. */
+        bool valid_timestamp = false;
+
+        double timestamp = 0.0;
+
+        /* Timestamp of the encoders snapshot the poses are evaluated from, if available. */
+        bool valid_pose_timestamp = false;
+
+        double pose_timestamp = 0.0;
+
+        /* Increasing for each grabbed frame. */
+        std::uint64_t sequence = 0;
+    };
 
     iCubCameraDepth(const std::string& robot_name, const std::string& port_prefix, const std::string& fallback_context_name, const std::string& fallback_configuration_name, const bool& use_calibration = false, const std::string& calibration_path = "");
 
@@ -45,17 +80,93 @@ public:
 
     std::pair<bool, Eigen::MatrixXf> depth(const bool& blocking) override;
 
+    /**
+     * The storage of the output is reused, while grabbing the stereo frame, rectification and stereo matching may still allocate.
+     */
+    bool depth(const bool& blocking, Eigen::MatrixXf& depth) override;
+
+    /**
+     * The confidence map is evaluated from the same disparity as the depth, hence the depth is the one returned by depth(),
+     * and marks as unreliable (0) those pixels for which SGBM did not provide a disparity (i.e. failing the uniqueness check,
+     * removed by the speckle filter or, if enabled, failing the left-right consistency check) or that fall outside the rectified image.
+     */
+    std::tuple<bool, Eigen::MatrixXf, Eigen::MatrixXf> depth_with_confidence(const bool& blocking) override;
+
+    bool depth_with_confidence(const bool& blocking, Eigen::MatrixXf& depth, Eigen::MatrixXf& confidence) override;
+
     std::pair<bool, Eigen::Transform<double, 3, Eigen::Affine>> pose(const bool& blocking) override;
 
     std::pair<bool, cv::Mat> rgb(const bool& blocking) override;
 
+    using RobotsIO::Camera::Camera::rgb;
+
+    /**
+     * All the data refer to the same, newly grabbed, stereo frame. The images and the depth share the timestamp of the left image,
+     * while the pose has the timestamp of the encoders snapshot it is evaluated from.
+     */
+    std::pair<bool, RobotsIO::Camera::Camera::Frame> frame(const bool& blocking, const bool& enable_depth = true) override;
+
+    /**
+     * The whole stereo frame underlying rgb(), depth() and pose(), or frame() and point_cloud() if called last.
+     */
+    std::pair<bool, std::shared_ptr<const StereoFrame>> stereo_frame(const bool& blocking);
+
+    /**
+     * Offline playback.
+     */
+
+    bool step_frame() override;
+
+    bool set_frame_index(const std::int32_t& index) override;
+
+protected:
+    /**
+     * The colors, the depth and the pose are taken from a single, newly grabbed, stereo frame.
+     */
+    bool point_cloud_data(const bool& blocking, const bool& use_root_frame, const bool& enable_colors, const bool& use_confidence, Eigen::Transform<double, 3, Eigen::Affine>& camera_pose) override;
+
 private:
+    /**
+     * Frame-coherent acquisition.
+     *
+     * A new stereo frame is grabbed only when the caller requests again something already consumed from the current one,
+     * e.g. rgb(), depth(), depth_with_confidence() and pose() called once each, in any order, all refer to the same stereo pair.
+     * Methods using the whole frame at once, i.e. frame() and point_cloud(), always grab a new one and consume it entirely.
+     */
+
+    std::pair<bool, std::shared_ptr<const StereoFrame>> acquire_stereo_frame(const bool& blocking, bool& consumed);
+
+    std::pair<bool, std::shared_ptr<const StereoFrame>> acquire_whole_stereo_frame(const bool& blocking);
+
+    std::pair<bool, std::shared_ptr<const StereoFrame>> grab_stereo_frame(const bool& blocking);
+
+    std::uint64_t stereo_frame_sequence_ = 0;
+
+    void drop_stereo_frame();
+
+    std::shared_ptr<const StereoFrame> stereo_frame_;
+
+    /* Frames are recycled once they are not referenced anymore. */
+    RobotsIO::Utils::BufferPool<StereoFrame> stereo_frame_pool_;
+
+    bool rgb_consumed_ = true;
+
+    bool depth_consumed_ = true;
+
+    bool confidence_consumed_ = true;
+
+    bool pose_consumed_ = true;
+
+    bool stereo_frame_consumed_ = true;
+
     /**
      * Storage required for stereo matching with OpenCV.
      */
 
     void configure_sgbm();
 
+    bool stereo_depth(const StereoFrame& frame, const bool& evaluate_confidence, Eigen::MatrixXf& depth, Eigen::MatrixXf& confidence);
+
     cv::Mat intrinsic_left_;
 
     cv::Mat distortion_left_;
@@ -66,6 +177,47 @@ private:
 
     cv::Ptr<cv::StereoSGBM> sgbm_;
 
+    /**
+     * Rectification, evaluated again only if the extrinsics change, and buffers reused across frames.
+     */
+
+    bool rectification_valid_ = false;
+
+    Eigen::Transform<double, 3, Eigen::Affine> rectification_extrinsics_;
+
+    cv::Size rectification_size_;
+
+    cv::Mat R1_;
+
+    cv::Mat R2_;
+
+    cv::Mat P1_;
+
+    cv::Mat P2_;
+
+    cv::Mat Q_;
+
+    cv::Mat mapl0_;
+
+    cv::Mat mapl1_;
+
+    cv::Mat mapr0_;
+
+    cv::Mat mapr1_;
+
+    cv::Mat map_;
+
+    cv::Mat rgb_left_rect_;
+
+    cv::Mat rgb_right_rect_;
+
+    /* Disparity of the stereo frame with the given sequence, such that it is evaluated once per frame. */
+    cv::Mat disparity_;
+
+    bool valid_disparity_ = false;
+
+    std::uint64_t disparity_sequence_ = 0;
+
     /**
      * Parameters for OpenCV SGBM.
      * TODO: put them in the constructor somehow
@@ -8,8 +8,12 @@
 #ifndef ROBOTSIO_ICUBCAMERARELATIVE_H
 #define ROBOTSIO_ICUBCAMERARELATIVE_H
 
+#include <RobotsIO/Camera/YarpStereoSynchronizer.h>
 #include <RobotsIO/Camera/iCubCamera.h>
 
+#include <memory>
+#include <tuple>
+
 namespace RobotsIO {
     namespace Camera {
         class iCubCameraRelative;
@@ -35,6 +39,21 @@ public:
 
     std::pair<bool, Eigen::Transform<double, 3, Eigen::Affine>> pose(const bool& blocking) override;
 
+    /**
+     * Stereo synchronization.
+     *
+     * Once enabled, left and right images are received on the dedicated ports
+     * /<port_prefix>_relative_stereo/{left, right}/rgbImage:i and paired using their timestamps.
+     */
+
+    bool enable_stereo_synchronization(const double& tolerance, const std::size_t& buffer_size = 4);
+
+    std::pair<bool, RobotsIO::Camera::YarpStereoSynchronizer::StereoPair> rgb_pair(const bool& blocking);
+
+    std::pair<bool, RobotsIO::Camera::YarpStereoSynchronizer::Statistics> stereo_synchronization_statistics() const;
+
+    bool is_stereo_synchronized() const;
+
     /**
      * Offline playback.
      */
@@ -48,7 +67,19 @@ protected:
 
     const RobotsIO::Camera::iCubCamera& get_relative_camera() const;
 
+    /**
+     * Poses of the left and right cameras evaluated using a single encoders snapshot.
+     */
+    std::tuple<bool, Eigen::Transform<double, 3, Eigen::Affine>, Eigen::Transform<double, 3, Eigen::Affine>> stereo_poses();
+
+    /**
+     * As above, with the snapshot aligned with the given timestamp if the encoders are polled (see acquire_encoders_snapshot_at()).
+     */
+    std::tuple<bool, Eigen::Transform<double, 3, Eigen::Affine>, Eigen::Transform<double, 3, Eigen::Affine>> stereo_poses_at(const double& timestamp);
+
 private:
+    std::tuple<bool, Eigen::Transform<double, 3, Eigen::Affine>, Eigen::Transform<double, 3, Eigen::Affine>> stereo_poses_from_encoders(const EncodersSnapshot& snapshot);
+
     /**
      * Log name to be used in messages printed by the class.
      */
@@ -58,6 +89,10 @@ private:
      * In offline mode, we need an additional instance to read data of both cameras.
      */
     std::unique_ptr<RobotsIO::Camera::iCubCamera> left_camera_;
+
+    std::string port_prefix_;
+
+    std::unique_ptr<RobotsIO::Camera::YarpStereoSynchronizer> stereo_synchronizer_;
 };
 
 #endif /* ROBOTSIO_ICUBCAMERARELATIVE_H */
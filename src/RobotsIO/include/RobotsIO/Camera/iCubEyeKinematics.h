@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef ROBOTSIO_ICUBEYEKINEMATICS_H
+#define ROBOTSIO_ICUBEYEKINEMATICS_H
+
+#include <Eigen/Dense>
+#include <Eigen/StdVector>
+
+#include <string>
+#include <vector>
+
+namespace RobotsIO {
+    namespace Camera {
+        class iCubEyeKinematics;
+    }
+}
+
+
+/**
+ * Forward kinematics of the iCub eye chains using fixed-size types only.
+ *
+ * The Denavit-Hartenberg parameters are taken once, at construction time, from iCub::iKin::iCubEye
+ * such that the resulting poses are those provided by iKin, while their evaluation does not require heap allocations.
+ */
+class RobotsIO::Camera::iCubEyeKinematics
+{
+public:
+    static constexpr std::size_t number_of_links = 8;
+
+    /* Joints in chain order, i.e. torso yaw, roll and pitch, neck pitch, roll and yaw, eyes tilt and eye pan, in radians. */
+    typedef Eigen::Matrix<double, number_of_links, 1> Joints;
+
+    /* Torso (3) and head (6) encoders, in degrees, as provided by the robot. */
+    typedef Eigen::Matrix<double, 9, 1> Encoders;
+
+    typedef std::vector<Eigen::Transform<double, 3, Eigen::Affine>, Eigen::aligned_allocator<Eigen::Transform<double, 3, Eigen::Affine>>> Poses;
+
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    /**
+     * The type is any iCub::iKin::iCubEye type, e.g. left_v2 or right_v2.
+     */
+    iCubEyeKinematics(const std::string& type);
+
+    Eigen::Transform<double, 3, Eigen::Affine> pose(const Joints& joints) const;
+
+    Eigen::Transform<double, 3, Eigen::Affine> pose_from_encoders(const Eigen::Ref<const Eigen::Vector3d>& torso, const Eigen::Ref<const Eigen::Matrix<double, 6, 1>>& head) const;
+
+    /**
+     * Poses for many configurations at once, one per column of the input matrix
+     * (torso and head encoders, as stored in the auxiliary data of iCubCamera).
+     */
+    Poses poses_from_encoders(const Eigen::Ref<const Eigen::MatrixXd>& encoders) const;
+
+    Joints joints_from_encoders(const Eigen::Ref<const Eigen::Vector3d>& torso, const Eigen::Ref<const Eigen::Matrix<double, 6, 1>>& head) const;
+
+private:
+    bool is_left_ = true;
+
+    Eigen::Matrix4d H0_;
+
+    Eigen::Matrix4d HN_;
+
+    /* Denavit-Hartenberg parameters. */
+    Eigen::Matrix<double, number_of_links, 1> a_;
+
+    Eigen::Matrix<double, number_of_links, 1> d_;
+
+    Eigen::Matrix<double, number_of_links, 1> cos_alpha_;
+
+    Eigen::Matrix<double, number_of_links, 1> sin_alpha_;
+
+    Eigen::Matrix<double, number_of_links, 1> offset_;
+
+    /**
+     * Log name to be used in messages printed by the class.
+     */
+
+    const std::string log_name_ = "iCubEyeKinematics";
+};
+
+#endif /* ROBOTSIO_ICUBEYEKINEMATICS_H */
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef ROBOTSIO_ASYNCPROBE_H
+#define ROBOTSIO_ASYNCPROBE_H
+
+#include <RobotsIO/Utils/Data.h>
+#include <RobotsIO/Utils/Probe.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace RobotsIO {
+    namespace Utils {
+        class AsyncProbe;
+    }
+}
+
+
+/**
+ * Decorator dispatching the data to the wrapped probe on a worker thread.
+ *
+ * Data is stored in a bounded queue, whose slots are recycled such that, in steady state, data of the same type
+ * is queued without allocations. When the queue is full, the policy decides whether to drop the oldest data,
+ * to drop the newest data or to block the caller until there is room for it.
+ *
+ * Data still queued on destruction is dispatched before the worker thread terminates.
+ * Exceptions thrown by the wrapped probe are caught on the worker thread and counted as failed.
+ *
+ * Data is queued through the type-erased interface of Probe only, hence ProbeContainer::get_typed_probe()
+ * returns nullptr for an AsyncProbe, even if the wrapped probe is a TypedProbe.
+ */
+class RobotsIO::Utils::AsyncProbe : public RobotsIO::Utils::Probe
+{
+public:
+    enum class Policy { DropOldest, DropNewest, Block };
+
+    /**
+     * With Policy::DropOldest, data can be enqueued and then dropped when evicted from the queue.
+     */
+    struct Counters
+    {
+        std::uint64_t enqueued = 0;
+
+        std::uint64_t dispatched = 0;
+
+        std::uint64_t dropped = 0;
+
+        /* Dispatched data for which the wrapped probe threw. */
+        std::uint64_t failed = 0;
+    };
+
+    AsyncProbe(std::unique_ptr<RobotsIO::Utils::Probe> probe, const std::size_t& capacity = 16, const Policy& policy = Policy::DropOldest);
+
+    virtual ~AsyncProbe();
+
+    Counters counters() const;
+
+    /**
+     * Dispatches the data still queued, terminates the worker thread and returns the wrapped probe.
+     * The AsyncProbe should not be used afterwards, other than for being destroyed.
+     */
+    std::unique_ptr<RobotsIO::Utils::Probe> release();
+
+protected:
+    void on_new_data() override;
+
+private:
+    void run();
+
+    void stop();
+
+    std::unique_ptr<RobotsIO::Utils::Probe> probe_;
+
+    const Policy policy_;
+
+    /* Ring of slots, protected by the mutex. */
+    std::vector<RobotsIO::Utils::Data> slots_;
+
+    std::size_t head_ = 0;
+
+    std::size_t size_ = 0;
+
+    bool running_ = true;
+
+    std::mutex mutex_;
+
+    std::condition_variable not_empty_;
+
+    std::condition_variable not_full_;
+
+    std::atomic<std::uint64_t> enqueued_;
+
+    std::atomic<std::uint64_t> dispatched_;
+
+    std::atomic<std::uint64_t> dropped_;
+
+    std::atomic<std::uint64_t> failed_;
+
+    std::thread worker_;
+
+    const std::string log_name_ = "AsyncProbe";
+};
+
+#endif /* ROBOTSIO_ASYNCPROBE_H */
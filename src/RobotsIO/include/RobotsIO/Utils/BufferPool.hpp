@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef ROBOTSIO_BUFFERPOOL_H
+#define ROBOTSIO_BUFFERPOOL_H
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace RobotsIO {
+    namespace Utils {
+        template<class T>
+        class BufferPool;
+    }
+}
+
+
+/**
+ * Pool of reference counted buffers.
+ *
+ * A buffer is reused once it is referenced only by the pool, such that its memory is recycled without allocations
+ * while buffers still referenced elsewhere are never overwritten. Buffers sharing their memory by other means,
+ * e.g. cv::Mat headers, can be kept out of the pool using the optional predicate.
+ */
+template<class T>
+class RobotsIO::Utils::BufferPool
+{
+public:
+    BufferPool(const std::function<bool(const T&)>& is_referenced = nullptr);
+
+    virtual ~BufferPool();
+
+    std::shared_ptr<T> acquire();
+
+    std::size_t size() const;
+
+private:
+    std::function<bool(const T&)> is_referenced_;
+
+    std::vector<std::shared_ptr<T>> buffers_;
+
+    mutable std::mutex mutex_;
+
+    const std::string log_name_ = "BufferPool";
+};
+
+
+template<class T>
+RobotsIO::Utils::BufferPool<T>::BufferPool(const std::function<bool(const T&)>& is_referenced) :
+    is_referenced_(is_referenced)
+{}
+
+
+template<class T>
+RobotsIO::Utils::BufferPool<T>::~BufferPool()
+{}
+
+
+template<class T>
+std::shared_ptr<T> RobotsIO::Utils::BufferPool<T>::acquire()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    /* A buffer referenced only by the pool cannot be acquired by others while the mutex is locked. */
+    for (const auto& buffer : buffers_)
+        if ((buffer.use_count() == 1) && !(is_referenced_ && is_referenced_(*buffer)))
+            return buffer;
+
+    buffers_.push_back(std::make_shared<T>());
+
+    return buffers_.back();
+}
+
+
+template<class T>
+std::size_t RobotsIO::Utils::BufferPool<T>::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    return buffers_.size();
+}
+
+#endif /* ROBOTSIO_BUFFERPOOL_H */
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef ROBOTSIO_FILEIMAGEPROBE_H
+#define ROBOTSIO_FILEIMAGEPROBE_H
+
+#include <RobotsIO/Utils/FileRecordWriter.h>
+#include <RobotsIO/Utils/TypedProbe.hpp>
+
+#include <opencv2/opencv.hpp>
+
+#include <string>
+#include <vector>
+
+namespace RobotsIO {
+    namespace Utils {
+        class FileImageProbe;
+    }
+}
+
+
+/**
+ * Probe saving images on disk, using FileRecordWriter.
+ *
+ * Each record contains the codec, the number of rows, the number of columns and the OpenCV type of the image (std::int32_t),
+ * followed by the image, either raw (row by row, without padding) or encoded. Records can be read back using FileRecordReader::read_image().
+ *
+ * Encoding takes place on the thread setting the data, hence the raw codec is the one sustaining the highest rates.
+ * In order to encode on a separate thread, the probe can be wrapped in an AsyncProbe.
+ *
+ * Setting data throws if writing to disk failed (see FileRecordWriter).
+ */
+class RobotsIO::Utils::FileImageProbe : public RobotsIO::Utils::TypedProbe<cv::Mat>
+{
+public:
+    enum class Codec { Raw = 0, Png = 1, Jpeg = 2 };
+
+    /**
+     * The quality is the PNG compression level (0 to 9) or the JPEG quality (0 to 100). A negative value uses the default of the codec.
+     */
+    FileImageProbe(const std::string& path, const Codec& codec = Codec::Png, const int& quality = -1, const std::size_t& batch_size = 1 << 23);
+
+    virtual ~FileImageProbe();
+
+    /**
+     * Returns false if writing to disk failed.
+     */
+    bool flush();
+
+protected:
+    void on_new_typed_data(const cv::Mat& data) override;
+
+private:
+    RobotsIO::Utils::FileRecordWriter writer_;
+
+    const Codec codec_;
+
+    std::vector<int> parameters_;
+
+    std::vector<unsigned char> buffer_;
+
+    const std::string log_name_ = "FileImageProbe";
+};
+
+#endif /* ROBOTSIO_FILEIMAGEPROBE_H */
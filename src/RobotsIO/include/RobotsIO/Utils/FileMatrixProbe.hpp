@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef ROBOTSIO_FILEMATRIXPROBE_H
+#define ROBOTSIO_FILEMATRIXPROBE_H
+
+#include <Eigen/Dense>
+
+#include <RobotsIO/Utils/FileRecordWriter.h>
+#include <RobotsIO/Utils/TypedProbe.hpp>
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace RobotsIO {
+    namespace Utils {
+        template <class U>
+        struct FileMatrixConversion;
+
+        template <class U>
+        struct FileMatrixDirect;
+
+        template <class U>
+        class FileMatrixProbe;
+    }
+}
+
+
+/**
+ * Conversion from data of type U to a matrix of doubles.
+ *
+ * The default implementation assigns the data to the matrix, hence it supports Eigen matrices and vectors of doubles.
+ * Support for other types is added by specializing this class.
+ */
+template <class U>
+struct RobotsIO::Utils::FileMatrixConversion
+{
+    static void convert(const U& data, Eigen::MatrixXd& output)
+    {
+        output = data;
+    }
+};
+
+
+/**
+ * Whether data of type U is a matrix of doubles whose storage is in column-major order, such that
+ * it is written as is, without being converted.
+ */
+template <class U>
+struct RobotsIO::Utils::FileMatrixDirect : std::false_type
+{};
+
+
+template <int Rows, int Cols, int Options, int MaxRows, int MaxCols>
+struct RobotsIO::Utils::FileMatrixDirect<Eigen::Matrix<double, Rows, Cols, Options, MaxRows, MaxCols>> :
+    std::integral_constant<bool, !(Options & Eigen::RowMajor) || (Rows == 1) || (Cols == 1)>
+{};
+
+
+/**
+ * Transformations, stored as a column vector x-y-z-axis-angle.
+ */
+template <>
+struct RobotsIO::Utils::FileMatrixConversion<Eigen::Transform<double, 3, Eigen::Affine>>
+{
+    static void convert(const Eigen::Transform<double, 3, Eigen::Affine>& data, Eigen::MatrixXd& output)
+    {
+        output.resize(7, 1);
+        output.col(0).head<3>() = data.translation();
+
+        Eigen::AngleAxisd axis_angle(data.rotation());
+        output.col(0).segment<3>(3) = axis_angle.axis();
+        output(6, 0) = axis_angle.angle();
+    }
+};
+
+
+/**
+ * Quaternions, stored as a column vector x-y-z-w.
+ */
+template <>
+struct RobotsIO::Utils::FileMatrixConversion<Eigen::Quaterniond>
+{
+    static void convert(const Eigen::Quaterniond& data, Eigen::MatrixXd& output)
+    {
+        output = data.coeffs();
+    }
+};
+
+
+/**
+ * Probe saving vectors, transformations or point clouds (e.g. as given by Camera::point_cloud()) on disk, using FileRecordWriter.
+ *
+ * Each record contains the number of rows and columns (std::uint64_t) followed by the elements of the matrix
+ * (double) in column-major order. Records can be read back using FileRecordReader::read_matrix().
+ *
+ * Setting data throws if writing to disk failed (see FileRecordWriter).
+ */
+template <class U>
+class RobotsIO::Utils::FileMatrixProbe : public RobotsIO::Utils::TypedProbe<U>
+{
+public:
+    FileMatrixProbe(const std::string& path, const std::size_t& batch_size = 1 << 20);
+
+    virtual ~FileMatrixProbe();
+
+    /**
+     * Returns false if writing to disk failed.
+     */
+    bool flush();
+
+protected:
+    void on_new_typed_data(const U& data) override;
+
+private:
+    void write_matrix(const double& timestamp, const U& data, std::true_type);
+
+    void write_matrix(const double& timestamp, const U& data, std::false_type);
+
+    void write_record(const double& timestamp, const std::uint64_t& rows, const std::uint64_t& cols, const double* data);
+
+    RobotsIO::Utils::FileRecordWriter writer_;
+
+    Eigen::MatrixXd matrix_;
+
+    const std::string log_name_ = "FileMatrixProbe";
+};
+
+
+template <class U>
+RobotsIO::Utils::FileMatrixProbe<U>::FileMatrixProbe(const std::string& path, const std::size_t& batch_size) :
+    writer_(path, batch_size)
+{}
+
+
+template <class U>
+RobotsIO::Utils::FileMatrixProbe<U>::~FileMatrixProbe()
+{}
+
+
+template <class U>
+bool RobotsIO::Utils::FileMatrixProbe<U>::flush()
+{
+    return writer_.flush();
+}
+
+
+template <class U>
+void RobotsIO::Utils::FileMatrixProbe<U>::on_new_typed_data(const U& data)
+{
+    write_matrix(RobotsIO::Utils::FileRecordWriter::now(), data, typename RobotsIO::Utils::FileMatrixDirect<U>::type());
+}
+
+
+template <class U>
+void RobotsIO::Utils::FileMatrixProbe<U>::write_matrix(const double& timestamp, const U& data, std::true_type)
+{
+    /* The writer copies the storage of the matrix into its pending batch, hence no intermediate copy is needed. */
+    write_record(timestamp, data.rows(), data.cols(), data.data());
+}
+
+
+template <class U>
+void RobotsIO::Utils::FileMatrixProbe<U>::write_matrix(const double& timestamp, const U& data, std::false_type)
+{
+    RobotsIO::Utils::FileMatrixConversion<U>::convert(data, matrix_);
+
+    write_record(timestamp, matrix_.rows(), matrix_.cols(), matrix_.data());
+}
+
+
+template <class U>
+void RobotsIO::Utils::FileMatrixProbe<U>::write_record(const double& timestamp, const std::uint64_t& rows, const std::uint64_t& cols, const double* data)
+{
+    const std::uint64_t shape[2] = {rows, cols};
+    if (!writer_.write(timestamp, reinterpret_cast<const char*>(shape), sizeof(shape), reinterpret_cast<const char*>(data), rows * cols * sizeof(double)))
+        throw(std::runtime_error(log_name_ + "::on_new_typed_data. Error: cannot write to disk."));
+}
+
+#endif /* ROBOTSIO_FILEMATRIXPROBE_H */
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef ROBOTSIO_FILERECORDREADER_H
+#define ROBOTSIO_FILERECORDREADER_H
+
+#include <Eigen/Dense>
+
+#include <opencv2/opencv.hpp>
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace RobotsIO {
+    namespace Utils {
+        class FileRecordReader;
+    }
+}
+
+
+/**
+ * Replays the records stored by FileRecordWriter, in any order.
+ *
+ * Besides raw records, it decodes those stored by FileMatrixProbe and FileImageProbe.
+ */
+class RobotsIO::Utils::FileRecordReader
+{
+public:
+    FileRecordReader(const std::string& path);
+
+    virtual ~FileRecordReader();
+
+    std::size_t number_records() const;
+
+    std::pair<bool, double> timestamp(const std::size_t& index) const;
+
+    /**
+     * The outputs are resized only if required.
+     */
+
+    bool read(const std::size_t& index, double& timestamp, std::vector<char>& data);
+
+    bool read_matrix(const std::size_t& index, double& timestamp, Eigen::MatrixXd& data);
+
+    bool read_image(const std::size_t& index, double& timestamp, cv::Mat& image);
+
+private:
+    struct Entry
+    {
+        double timestamp;
+
+        std::uint64_t offset;
+
+        std::uint64_t size;
+    };
+
+    std::ifstream log_;
+
+    std::vector<Entry> entries_;
+
+    std::vector<char> record_;
+
+    const std::string log_name_ = "FileRecordReader";
+};
+
+#endif /* ROBOTSIO_FILERECORDREADER_H */
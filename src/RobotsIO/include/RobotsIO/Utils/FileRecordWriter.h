@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef ROBOTSIO_FILERECORDWRITER_H
+#define ROBOTSIO_FILERECORDWRITER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace RobotsIO {
+    namespace Utils {
+        class FileRecordWriter;
+    }
+}
+
+
+/**
+ * Append-only log of timestamped records, written asynchronously in batches.
+ *
+ * Records are stored back to back in the file at the given path, while the file with the same path
+ * followed by ".index" contains, for each record, its timestamp (double), its offset within the log (std::uint64_t)
+ * and its size (std::uint64_t). Values are stored in the native byte order. See FileRecordReader for reading them back.
+ *
+ * Records are accumulated in memory and written on a worker thread once the pending data exceeds the batch size,
+ * after 0.1 seconds or when flushed. Writing waits only if the worker lags behind by more than four batches.
+ *
+ * Once writing to disk fails, write() and flush() return false and the records pending or written afterwards are discarded.
+ */
+class RobotsIO::Utils::FileRecordWriter
+{
+public:
+    FileRecordWriter(const std::string& path, const std::size_t& batch_size = 1 << 20);
+
+    virtual ~FileRecordWriter();
+
+    /**
+     * The record is the concatenation of the provided parts.
+     * Returns false if writing to disk failed, either for this record or for a previous one.
+     */
+    bool write(const double& timestamp, const char* data, const std::size_t& size, const char* data_tail = nullptr, const std::size_t& size_tail = 0);
+
+    /**
+     * Waits until all the records written so far are stored on disk.
+     * Returns false if writing to disk failed.
+     */
+    bool flush();
+
+    std::uint64_t number_records() const;
+
+    std::uint64_t number_bytes() const;
+
+    /**
+     * Current time, in seconds since the epoch, used to stamp records.
+     */
+    static double now();
+
+private:
+    void run();
+
+    std::ofstream log_;
+
+    std::ofstream index_;
+
+    const std::size_t batch_size_;
+
+    /* Protected by the mutex. */
+    std::vector<char> pending_log_;
+
+    std::vector<char> pending_index_;
+
+    std::uint64_t number_records_ = 0;
+
+    std::uint64_t number_bytes_ = 0;
+
+    std::uint64_t number_bytes_written_ = 0;
+
+    bool flush_requested_ = false;
+
+    bool failed_ = false;
+
+    bool running_ = true;
+
+    mutable std::mutex mutex_;
+
+    std::condition_variable pending_;
+
+    std::condition_variable written_;
+
+    std::thread worker_;
+
+    const std::string log_name_ = "FileRecordWriter";
+};
+
+#endif /* ROBOTSIO_FILERECORDWRITER_H */
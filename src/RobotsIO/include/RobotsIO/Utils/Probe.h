@@ -9,7 +9,10 @@
 #define ROBOTSIO_PROBE_H
 
 #include <RobotsIO/Utils/Data.h>
+#include <RobotsIO/Utils/ProbeStatistics.h>
+#include <RobotsIO/Utils/ProbeThrottle.h>
 
+#include <memory>
 #include <string>
 
 namespace RobotsIO {
@@ -25,14 +28,52 @@ public:
 
     void set_data(const RobotsIO::Utils::Data&);
 
+    /**
+     * Last data set through set_data(const RobotsIO::Utils::Data&).
+     * Data handed to a TypedProbe through its typed interface is not stored, hence it is not returned.
+     */
     RobotsIO::Utils::Data& get_data();
 
+    const RobotsIO::Utils::ProbeStatistics& statistics() const;
+
+    /**
+     * Limits the data accepted by the probe, nullptr removing the limit. The throttle is not thread safe,
+     * hence it should be set while no data is being set.
+     */
+    void set_throttle(std::unique_ptr<RobotsIO::Utils::ProbeThrottle> throttle);
+
+    /**
+     * The throttle, or nullptr if not set.
+     */
+    RobotsIO::Utils::ProbeThrottle* get_throttle();
+
+    std::unique_ptr<RobotsIO::Utils::ProbeThrottle> release_throttle();
+
 protected:
     virtual void on_new_data() = 0;
 
+    /**
+     * Whether new data should be accepted, checked, after the throttle, before the data is stored.
+     * The default implementation always returns true.
+     */
+    virtual bool accept_data();
+
+    /**
+     * Checks the throttle and accept_data(), to be used by probes accepting data through other interfaces (see TypedProbe).
+     */
+    bool is_data_accepted();
+
+    /**
+     * Calls, drops and the duration of on_new_data() are accounted by set_data(),
+     * while probes knowing the size of the data account for the bytes.
+     */
+    RobotsIO::Utils::ProbeStatistics statistics_;
+
 private:
     RobotsIO::Utils::Data data_;
 
+    std::unique_ptr<RobotsIO::Utils::ProbeThrottle> throttle_;
+
     const std::string log_name_ = "Probe";
 };
 
@@ -8,8 +8,15 @@
 #ifndef ROBOTSIO_PROBECONTAINER_H
 #define ROBOTSIO_PROBECONTAINER_H
 
+#include <RobotsIO/Utils/AsyncProbe.h>
 #include <RobotsIO/Utils/Probe.h>
+#include <RobotsIO/Utils/ProbeHandle.h>
+#include <RobotsIO/Utils/ProbeStatistics.h>
+#include <RobotsIO/Utils/ProbeThrottle.h>
+#include <RobotsIO/Utils/TypedProbe.hpp>
 
+#include <map>
+#include <memory>
 #include <string>
 #include <unordered_map>
 
@@ -29,12 +36,65 @@ public:
 
     RobotsIO::Utils::Probe& get_probe(const std::string& name);
 
+    /**
+     * The probe, if it accepts data of type T, or nullptr otherwise.
+     * The pointer is valid until the probe is replaced and is meant to be retrieved once,
+     * such that data can be set without looking up the probe each time.
+     * Decorators accepting data only through the type-erased interface, e.g. AsyncProbe, are not returned.
+     */
+    template<class T>
+    RobotsIO::Utils::TypedProbe<T>* get_typed_probe(const std::string& name);
+
     void set_probe(const std::string& name, std::unique_ptr<RobotsIO::Utils::Probe> probe);
 
+    /**
+     * Limits the data accepted by the probe with the given name, installing a ProbeThrottle on it.
+     * The policy applies to the probe currently set, if any, and to those set afterwards.
+     * Throttled probes are still returned by get_typed_probe(), unless the policy coalesces the data,
+     * in which case the probe is wrapped in an AsyncProbe keeping only the newest data.
+     */
+    void set_probe_policy(const std::string& name, const RobotsIO::Utils::ProbeThrottle::Policy& policy);
+
+    /**
+     * Handle to the probe with the given name, which need not be set yet.
+     * Meant to be retrieved once, such that data can be set without looking up the probe by name each time.
+     */
+    RobotsIO::Utils::ProbeHandle get_probe_handle(const std::string& name);
+
+    /**
+     * Statistics of the probes currently set, sorted by name.
+     */
+    std::map<std::string, RobotsIO::Utils::ProbeStatistics::Snapshot> probe_statistics() const;
+
+    /**
+     * Statistics of the probes currently set, one line per probe, with durations in microseconds.
+     */
+    std::string probe_statistics_to_text() const;
+
+    /**
+     * Statistics of the probes currently set, as a JSON object indexed by the name of the probe.
+     */
+    std::string probe_statistics_to_json() const;
+
 protected:
+    static std::unique_ptr<RobotsIO::Utils::Probe> apply_policy(std::unique_ptr<RobotsIO::Utils::Probe> probe, const RobotsIO::Utils::ProbeThrottle::Policy& policy);
+
     std::unordered_map<std::string, std::unique_ptr<RobotsIO::Utils::Probe>> probes_;
 
+    std::unordered_map<std::string, RobotsIO::Utils::ProbeThrottle::Policy> policies_;
+
     const std::string log_name_ = "ProbeContainer";
 };
 
+
+template<class T>
+RobotsIO::Utils::TypedProbe<T>* RobotsIO::Utils::ProbeContainer::get_typed_probe(const std::string& name)
+{
+    auto probe = probes_.find(name);
+    if ((probe == probes_.end()) || (probe->second == nullptr))
+        return nullptr;
+
+    return dynamic_cast<RobotsIO::Utils::TypedProbe<T>*>(probe->second.get());
+}
+
 #endif /* ROBOTSIO_PROBECONTAINER_H */
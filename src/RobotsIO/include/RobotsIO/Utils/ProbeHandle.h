@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef ROBOTSIO_PROBEHANDLE_H
+#define ROBOTSIO_PROBEHANDLE_H
+
+#include <RobotsIO/Utils/Data.h>
+#include <RobotsIO/Utils/Probe.h>
+
+#include <memory>
+
+namespace RobotsIO {
+    namespace Utils {
+        class ProbeContainer;
+        class ProbeHandle;
+    }
+}
+
+
+/**
+ * Cheap reference to a named probe of a ProbeContainer, resolved once (see ProbeContainer::get_probe_handle()).
+ *
+ * The handle follows the probe set with that name, even if it is set or replaced after the handle is created,
+ * and setting data through a handle to a probe that is not set does nothing.
+ * A handle is valid as long as the container that created it.
+ */
+class RobotsIO::Utils::ProbeHandle
+{
+public:
+    /**
+     * A handle not referring to any probe.
+     */
+    ProbeHandle();
+
+    bool is_probe() const;
+
+    void set_data(const RobotsIO::Utils::Data& data) const;
+
+    /**
+     * The probe, or nullptr if not set.
+     */
+    RobotsIO::Utils::Probe* get() const;
+
+private:
+    ProbeHandle(std::unique_ptr<RobotsIO::Utils::Probe>* probe);
+
+    /* Slot of the probe within the container. */
+    std::unique_ptr<RobotsIO::Utils::Probe>* probe_;
+
+    friend class RobotsIO::Utils::ProbeContainer;
+};
+
+#endif /* ROBOTSIO_PROBEHANDLE_H */
@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef ROBOTSIO_PROBESTATISTICS_H
+#define ROBOTSIO_PROBESTATISTICS_H
+
+#include <Eigen/Core>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/* Forward declared, such that users of probes do not depend on the headers of OpenCV and YARP. */
+namespace cv {
+    class Mat;
+}
+
+namespace yarp {
+    namespace sig {
+        template<class T>
+        class VectorOf;
+    }
+}
+
+namespace RobotsIO {
+    namespace Utils {
+        class ProbeStatistics;
+
+        /**
+         * Size, in bytes, of the data set to a probe, as accounted by ProbeStatistics.
+         * For containers, the size of the elements is accounted, not the one of the memory they might own.
+         */
+        template<class T>
+        typename std::enable_if<!std::is_base_of<Eigen::EigenBase<T>, T>::value, std::size_t>::type probe_data_size(const T&);
+
+        template<class T>
+        typename std::enable_if<std::is_base_of<Eigen::EigenBase<T>, T>::value, std::size_t>::type probe_data_size(const T& data);
+
+        template<class T, class Allocator>
+        std::size_t probe_data_size(const std::vector<T, Allocator>& data);
+
+        template<class T, std::size_t N>
+        std::size_t probe_data_size(const std::array<T, N>& data);
+
+        template<class CharT, class Traits, class Allocator>
+        std::size_t probe_data_size(const std::basic_string<CharT, Traits, Allocator>& data);
+
+        template<class T>
+        std::size_t probe_data_size(const yarp::sig::VectorOf<T>& data);
+
+        std::size_t probe_data_size(const cv::Mat& data);
+    }
+}
+
+
+/**
+ * Statistics of a probe: number of calls, data dropped, bytes, duration of the processing of the data and time of the last publication.
+ *
+ * Statistics are collected using atomic counters only, hence they can be read from any thread while the probe is being used.
+ * Durations are accumulated in a logarithmic histogram, with four sub-buckets per power of two, such that percentiles
+ * have a relative error within 12.5%.
+ */
+class RobotsIO::Utils::ProbeStatistics
+{
+public:
+    struct Snapshot
+    {
+        std::uint64_t calls = 0;
+
+        std::uint64_t dropped = 0;
+
+        std::uint64_t bytes = 0;
+
+        /* Durations, in seconds. */
+        double duration_p50 = 0.0;
+
+        double duration_p99 = 0.0;
+
+        /* Seconds since the epoch, 0 if data has never been published. */
+        double last_publish_time = 0.0;
+    };
+
+    ProbeStatistics();
+
+    void add_call();
+
+    void add_dropped();
+
+    void add_bytes(const std::size_t& bytes);
+
+    void add_publish(const std::chrono::steady_clock::duration& duration);
+
+    Snapshot snapshot() const;
+
+    void reset();
+
+private:
+    static std::size_t bucket(const std::uint64_t& nanoseconds);
+
+    static double bucket_value(const std::size_t& bucket);
+
+    double percentile(const std::array<std::uint64_t, 256>& counts, const std::uint64_t& total, const double& fraction) const;
+
+    std::atomic<std::uint64_t> calls_;
+
+    std::atomic<std::uint64_t> dropped_;
+
+    std::atomic<std::uint64_t> bytes_;
+
+    std::atomic<std::int64_t> last_publish_time_;
+
+    std::array<std::atomic<std::uint64_t>, 256> histogram_;
+
+    const std::string log_name_ = "ProbeStatistics";
+};
+
+
+template<class T>
+typename std::enable_if<!std::is_base_of<Eigen::EigenBase<T>, T>::value, std::size_t>::type RobotsIO::Utils::probe_data_size(const T&)
+{
+    return sizeof(T);
+}
+
+
+template<class T>
+typename std::enable_if<std::is_base_of<Eigen::EigenBase<T>, T>::value, std::size_t>::type RobotsIO::Utils::probe_data_size(const T& data)
+{
+    return data.size() * sizeof(typename T::Scalar);
+}
+
+
+template<class T, class Allocator>
+std::size_t RobotsIO::Utils::probe_data_size(const std::vector<T, Allocator>& data)
+{
+    return data.size() * sizeof(T);
+}
+
+
+template<class T, std::size_t N>
+std::size_t RobotsIO::Utils::probe_data_size(const std::array<T, N>&)
+{
+    return N * sizeof(T);
+}
+
+
+template<class CharT, class Traits, class Allocator>
+std::size_t RobotsIO::Utils::probe_data_size(const std::basic_string<CharT, Traits, Allocator>& data)
+{
+    return data.size() * sizeof(CharT);
+}
+
+
+template<class T>
+std::size_t RobotsIO::Utils::probe_data_size(const yarp::sig::VectorOf<T>& data)
+{
+    return data.size() * sizeof(T);
+}
+
+#endif /* ROBOTSIO_PROBESTATISTICS_H */
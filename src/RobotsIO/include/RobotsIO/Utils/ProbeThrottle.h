@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef ROBOTSIO_PROBETHROTTLE_H
+#define ROBOTSIO_PROBETHROTTLE_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace RobotsIO {
+    namespace Utils {
+        class ProbeThrottle;
+    }
+}
+
+
+/**
+ * Limits the data accepted by a probe (see Probe::set_throttle()), with a maximum rate and a decimation.
+ *
+ * As the throttle is checked by the probe before the data is stored or converted, data exceeding the policy
+ * is dropped without copies, both when set through the type-erased interface of Probe and through the typed one of TypedProbe.
+ */
+class RobotsIO::Utils::ProbeThrottle
+{
+public:
+    struct Policy
+    {
+        /* Maximum rate, in Hz, not limited if not positive. */
+        double maximum_rate = 0.0;
+
+        /* One every decimation data is accepted, should be positive. */
+        std::size_t decimation = 1;
+
+        /* Keep only the newest data while the probe is busy. Applied by ProbeContainer::set_probe_policy(), not by the throttle. */
+        bool coalesce = false;
+    };
+
+    ProbeThrottle(const Policy& policy);
+
+    virtual ~ProbeThrottle();
+
+    const Policy& policy() const;
+
+    /**
+     * Changes the maximum rate and the decimation.
+     */
+    void set_policy(const Policy& policy);
+
+    /**
+     * Whether the next data is accepted, accounting it.
+     */
+    bool accept();
+
+    std::uint64_t number_dropped() const;
+
+private:
+    Policy policy_;
+
+    std::uint64_t number_received_ = 0;
+
+    std::uint64_t number_dropped_ = 0;
+
+    bool valid_last_time_ = false;
+
+    std::chrono::steady_clock::time_point last_time_;
+
+    const std::string log_name_ = "ProbeThrottle";
+};
+
+#endif /* ROBOTSIO_PROBETHROTTLE_H */
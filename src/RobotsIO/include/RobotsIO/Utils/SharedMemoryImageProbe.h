@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef ROBOTSIO_SHAREDMEMORYIMAGEPROBE_H
+#define ROBOTSIO_SHAREDMEMORYIMAGEPROBE_H
+
+#include <RobotsIO/Utils/SharedMemoryRing.h>
+#include <RobotsIO/Utils/TypedProbe.hpp>
+
+#include <opencv2/opencv.hpp>
+
+#include <string>
+#include <vector>
+
+namespace RobotsIO {
+    namespace Utils {
+        class SharedMemoryImageProbe;
+    }
+}
+
+
+/**
+ * Probe publishing images to processes on the same host using a SharedMemoryRing.
+ *
+ * Images are stored row by row, without padding, and described by {Content::Image, rows, columns, OpenCV type}.
+ * They can be read using SharedMemoryReader.
+ */
+class RobotsIO::Utils::SharedMemoryImageProbe : public RobotsIO::Utils::TypedProbe<cv::Mat>
+{
+public:
+    /**
+     * The slot size is the maximum size of an image, in bytes.
+     */
+    SharedMemoryImageProbe(const std::string& name, const std::size_t& slot_size, const std::size_t& number_slots = 4);
+
+    virtual ~SharedMemoryImageProbe();
+
+protected:
+    void on_new_typed_data(const cv::Mat& data) override;
+
+private:
+    RobotsIO::Utils::SharedMemoryRing ring_;
+
+    std::vector<char> buffer_;
+
+    const std::string log_name_ = "SharedMemoryImageProbe";
+};
+
+#endif /* ROBOTSIO_SHAREDMEMORYIMAGEPROBE_H */
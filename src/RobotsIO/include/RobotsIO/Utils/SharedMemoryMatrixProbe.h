@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef ROBOTSIO_SHAREDMEMORYMATRIXPROBE_H
+#define ROBOTSIO_SHAREDMEMORYMATRIXPROBE_H
+
+#include <Eigen/Dense>
+
+#include <RobotsIO/Utils/SharedMemoryRing.h>
+#include <RobotsIO/Utils/TypedProbe.hpp>
+
+#include <string>
+
+namespace RobotsIO {
+    namespace Utils {
+        class SharedMemoryMatrixProbe;
+    }
+}
+
+
+/**
+ * Probe publishing matrices, e.g. point clouds as given by Camera::point_cloud(), to processes on the same host using a SharedMemoryRing.
+ *
+ * Matrices are stored in column-major order and described by {Content::Matrix, rows, columns, 0}.
+ * They can be read using SharedMemoryReader.
+ */
+class RobotsIO::Utils::SharedMemoryMatrixProbe : public RobotsIO::Utils::TypedProbe<Eigen::MatrixXd>
+{
+public:
+    /**
+     * The slot size is the maximum number of elements of a matrix.
+     */
+    SharedMemoryMatrixProbe(const std::string& name, const std::size_t& slot_size, const std::size_t& number_slots = 4);
+
+    virtual ~SharedMemoryMatrixProbe();
+
+protected:
+    void on_new_typed_data(const Eigen::MatrixXd& data) override;
+
+private:
+    RobotsIO::Utils::SharedMemoryRing ring_;
+
+    const std::string log_name_ = "SharedMemoryMatrixProbe";
+};
+
+#endif /* ROBOTSIO_SHAREDMEMORYMATRIXPROBE_H */
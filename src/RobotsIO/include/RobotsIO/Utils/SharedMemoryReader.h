@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef ROBOTSIO_SHAREDMEMORYREADER_H
+#define ROBOTSIO_SHAREDMEMORYREADER_H
+
+#include <Eigen/Dense>
+
+#include <RobotsIO/Utils/SharedMemoryRing.h>
+
+#include <opencv2/opencv.hpp>
+
+#include <cstdint>
+#include <string>
+
+namespace RobotsIO {
+    namespace Utils {
+        class SharedMemoryReader;
+    }
+}
+
+
+/**
+ * Reads the data published by SharedMemoryImageProbe and SharedMemoryMatrixProbe.
+ *
+ * Each read returns the latest data newer than the one previously read, waiting for it up to the timeout,
+ * in seconds (a negative timeout waits indefinitely). Outputs are resized only if required.
+ * Zero-copy access is available through ring().
+ */
+class RobotsIO::Utils::SharedMemoryReader
+{
+public:
+    SharedMemoryReader(const std::string& name);
+
+    virtual ~SharedMemoryReader();
+
+    bool read_image(cv::Mat& image, double& timestamp, const double& timeout = -1.0);
+
+    bool read_matrix(Eigen::MatrixXd& matrix, double& timestamp, const double& timeout = -1.0);
+
+    const RobotsIO::Utils::SharedMemoryRing& ring() const;
+
+private:
+    std::pair<bool, RobotsIO::Utils::SharedMemoryRing::View> wait_view(const double& timeout);
+
+    RobotsIO::Utils::SharedMemoryRing ring_;
+
+    std::uint64_t sequence_ = 0;
+
+    const std::string log_name_ = "SharedMemoryReader";
+};
+
+#endif /* ROBOTSIO_SHAREDMEMORYREADER_H */
@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef ROBOTSIO_SHAREDMEMORYRING_H
+#define ROBOTSIO_SHAREDMEMORYRING_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+namespace RobotsIO {
+    namespace Utils {
+        class SharedMemoryRing;
+    }
+}
+
+
+/**
+ * Ring of fixed size slots in POSIX shared memory, written by a single process and read by any number of processes
+ * on the same host (Linux only).
+ *
+ * Each slot is protected by a sequence lock, such that the writer never waits for the readers, and readers detect whether
+ * a slot has been overwritten while being read. Readers waiting for new data sleep on a futex, which is woken up by the writer.
+ *
+ * Each write is identified by a sequence number, increasing from 1, and carries a timestamp, four integers
+ * describing the data (e.g. its shape) and the data itself.
+ *
+ * A writer always creates a new ring, replacing any ring with the same name, e.g. left by a writer that was restarted.
+ * Readers that mapped the previous ring keep reading it, without new data, and should be reopened.
+ */
+class RobotsIO::Utils::SharedMemoryRing
+{
+public:
+    /**
+     * Kinds of data written by the probes of the library, stored as the first integer of the description.
+     */
+    enum class Content : std::int32_t { Raw = 0, Image = 1, Matrix = 2 };
+
+    struct View
+    {
+        const char* data = nullptr;
+
+        std::size_t size = 0;
+
+        double timestamp = 0.0;
+
+        std::array<std::int32_t, 4> description;
+
+        std::uint64_t sequence = 0;
+
+        std::uint64_t lock = 0;
+    };
+
+    /**
+     * Creates the ring with the given name (which should start with '/'), to be written.
+     */
+    SharedMemoryRing(const std::string& name, const std::size_t& number_slots, const std::size_t& slot_size);
+
+    /**
+     * Opens the existing ring with the given name, to be read.
+     */
+    SharedMemoryRing(const std::string& name);
+
+    virtual ~SharedMemoryRing();
+
+    std::size_t slot_size() const;
+
+    /**
+     * Writer side. Returns false if the data does not fit a slot.
+     */
+    bool write(const double& timestamp, const std::array<std::int32_t, 4>& description, const char* data, const std::size_t& size);
+
+    /**
+     * Reader side.
+     */
+
+    std::uint64_t latest_sequence() const;
+
+    /**
+     * Waits until the latest sequence number is greater than the provided one or the timeout, in seconds,
+     * expires (a negative timeout waits indefinitely).
+     */
+    bool wait_newer(const std::uint64_t& sequence, const double& timeout = -1.0) const;
+
+    /**
+     * Zero-copy access to the latest data. The data can be used only as long as is_valid() returns true after using it,
+     * as the slot might be overwritten in the meantime.
+     */
+    std::pair<bool, View> view_latest() const;
+
+    bool is_valid(const View& view) const;
+
+private:
+    struct Header;
+
+    struct Slot;
+
+    Slot* slot(const std::size_t& index) const;
+
+    /**
+     * Whether the geometry in the header matches the one the memory was mapped with, which is the one used to access the slots.
+     */
+    bool is_consistent() const;
+
+    const std::string name_;
+
+    const bool owner_;
+
+    int descriptor_ = -1;
+
+    void* memory_ = nullptr;
+
+    std::size_t memory_size_ = 0;
+
+    Header* header_ = nullptr;
+
+    std::size_t number_slots_ = 0;
+
+    std::size_t slot_size_ = 0;
+
+    std::size_t slot_stride_ = 0;
+
+    const std::string log_name_ = "SharedMemoryRing";
+};
+
+#endif /* ROBOTSIO_SHAREDMEMORYRING_H */
@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef ROBOTSIO_TYPEDPROBE_H
+#define ROBOTSIO_TYPEDPROBE_H
+
+#include <RobotsIO/Utils/Data.h>
+#include <RobotsIO/Utils/Probe.h>
+#include <RobotsIO/Utils/any.h>
+
+#include <chrono>
+#include <string>
+#include <utility>
+
+namespace RobotsIO {
+    namespace Utils {
+        template<class T>
+        class TypedProbe;
+    }
+}
+
+
+/**
+ * Probe accepting data of type T.
+ *
+ * Data is handed to the probe by reference, hence without copies or allocations.
+ * Data set through the type-erased interface of Probe is still accepted, provided that it contains an instance of T.
+ *
+ * Storing typed data in Probe::get_data() would require the copy that the typed interface avoids,
+ * hence get_data() is not updated by the typed set_data() and only returns data set through the type-erased interface.
+ */
+template<class T>
+class RobotsIO::Utils::TypedProbe : public RobotsIO::Utils::Probe
+{
+public:
+    virtual ~TypedProbe();
+
+    using RobotsIO::Utils::Probe::set_data;
+
+    void set_data(const T& data);
+
+    void set_data(T&& data);
+
+protected:
+    virtual void on_new_typed_data(const T& data) = 0;
+
+    /**
+     * Called for data that can be moved. Probes keeping the data can override it in order to take ownership of it.
+     * The default implementation forwards to on_new_typed_data().
+     */
+    virtual void on_moved_typed_data(T&& data);
+
+private:
+    void on_new_data() override;
+
+    const std::string log_name_ = "TypedProbe";
+};
+
+
+template<class T>
+RobotsIO::Utils::TypedProbe<T>::~TypedProbe()
+{}
+
+
+template<class T>
+void RobotsIO::Utils::TypedProbe<T>::set_data(const T& data)
+{
+    this->statistics_.add_call();
+
+    if (!this->is_data_accepted())
+    {
+        this->statistics_.add_dropped();
+        return;
+    }
+
+    this->statistics_.add_bytes(RobotsIO::Utils::probe_data_size(data));
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    on_new_typed_data(data);
+    this->statistics_.add_publish(std::chrono::steady_clock::now() - start);
+}
+
+
+template<class T>
+void RobotsIO::Utils::TypedProbe<T>::set_data(T&& data)
+{
+    this->statistics_.add_call();
+
+    if (!this->is_data_accepted())
+    {
+        this->statistics_.add_dropped();
+        return;
+    }
+
+    this->statistics_.add_bytes(RobotsIO::Utils::probe_data_size(data));
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    on_moved_typed_data(std::move(data));
+    this->statistics_.add_publish(std::chrono::steady_clock::now() - start);
+}
+
+
+template<class T>
+void RobotsIO::Utils::TypedProbe<T>::on_moved_typed_data(T&& data)
+{
+    on_new_typed_data(data);
+}
+
+
+template<class T>
+void RobotsIO::Utils::TypedProbe<T>::on_new_data()
+{
+    const T* data = RobotsIO::Utils::any_cast<T>(&get_data());
+
+    if (data == nullptr)
+        throw(RobotsIO::Utils::bad_any_cast());
+
+    /* Calls and duration are accounted by Probe::set_data(). */
+    this->statistics_.add_bytes(RobotsIO::Utils::probe_data_size(*data));
+
+    on_new_typed_data(*data);
+}
+
+#endif /* ROBOTSIO_TYPEDPROBE_H */
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef ROBOTSIO_YARPBATCHEDVECTOROFPROBE_H
+#define ROBOTSIO_YARPBATCHEDVECTOROFPROBE_H
+
+#include <RobotsIO/Utils/TypedProbe.hpp>
+#include <RobotsIO/Utils/YarpBufferedPort.hpp>
+#include <RobotsIO/Utils/YarpVectorOfBatch.h>
+#include <RobotsIO/Utils/YarpVectorOfProbe.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <yarp/os/Time.h>
+#include <yarp/sig/Vector.h>
+
+namespace RobotsIO {
+    namespace Utils {
+        template <class U>
+        class YarpBatchedVectorOfProbe;
+    }
+}
+
+
+/**
+ * Probe collecting samples, stamped with the time they are set, and sending them in batches
+ * within a single yarp::sig::VectorOf<double> (see YarpVectorOfBatch.h for the layout and for unpacking).
+ *
+ * Samples are converted using YarpVectorOfConversion. A batch is sent once it contains the given number of samples,
+ * once the given period, in seconds, has elapsed since its first sample or once the size of the samples changes.
+ * As the period is checked when new samples are set, pending samples can be sent at any time using flush().
+ * They are also sent on destruction.
+ */
+template <class U>
+class RobotsIO::Utils::YarpBatchedVectorOfProbe : public RobotsIO::Utils::YarpBufferedPort<yarp::sig::VectorOf<double>>,
+                                                  public RobotsIO::Utils::TypedProbe<U>
+{
+public:
+    YarpBatchedVectorOfProbe(const std::string& port_name, const std::size_t& batch_size, const double& period = 0.1);
+
+    virtual ~YarpBatchedVectorOfProbe();
+
+    void flush();
+
+protected:
+    void on_new_typed_data(const U& data) override;
+
+private:
+    const std::size_t batch_size_;
+
+    const double period_;
+
+    /* Storage is reserved once for a whole batch. */
+    std::vector<double> batch_;
+
+    std::size_t number_samples_ = 0;
+
+    std::size_t sample_size_ = 0;
+
+    double first_timestamp_ = 0.0;
+
+    yarp::sig::VectorOf<double> sample_;
+
+    const std::string log_name_ = "YarpBatchedVectorOfProbe";
+};
+
+
+template <class U>
+RobotsIO::Utils::YarpBatchedVectorOfProbe<U>::YarpBatchedVectorOfProbe(const std::string& port_name, const std::size_t& batch_size, const double& period) :
+    YarpBufferedPort<yarp::sig::VectorOf<double>>(port_name),
+    batch_size_(batch_size),
+    period_(period)
+{
+    if (batch_size_ == 0)
+        throw(std::runtime_error(log_name_ + "::ctor. Error: the size of the batch should be positive."));
+}
+
+
+template <class U>
+RobotsIO::Utils::YarpBatchedVectorOfProbe<U>::~YarpBatchedVectorOfProbe()
+{
+    flush();
+}
+
+
+template <class U>
+void RobotsIO::Utils::YarpBatchedVectorOfProbe<U>::flush()
+{
+    if (number_samples_ == 0)
+        return;
+
+    batch_[0] = static_cast<double>(number_samples_);
+    batch_[1] = static_cast<double>(sample_size_);
+
+    yarp::sig::VectorOf<double>& output = this->port_.prepare();
+    if (output.size() != batch_.size())
+        output.resize(batch_.size());
+    std::copy(batch_.begin(), batch_.end(), output.data());
+
+    this->port_.write();
+
+    batch_.clear();
+    number_samples_ = 0;
+}
+
+
+template <class U>
+void RobotsIO::Utils::YarpBatchedVectorOfProbe<U>::on_new_typed_data(const U& data)
+{
+    const double timestamp = yarp::os::Time::now();
+
+    RobotsIO::Utils::YarpVectorOfConversion<double, U>::convert(data, sample_);
+
+    if ((number_samples_ > 0) && (sample_.size() != sample_size_))
+        flush();
+
+    if (number_samples_ == 0)
+    {
+        sample_size_ = sample_.size();
+        first_timestamp_ = timestamp;
+
+        batch_.reserve(2 + batch_size_ * (sample_size_ + 1));
+        batch_.resize(2);
+    }
+
+    batch_.push_back(timestamp);
+    batch_.insert(batch_.end(), sample_.data(), sample_.data() + sample_size_);
+    number_samples_++;
+
+    if ((number_samples_ == batch_size_) || ((timestamp - first_timestamp_) >= period_))
+        flush();
+}
+
+#endif /* ROBOTSIO_YARPBATCHEDVECTOROFPROBE_H */
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef ROBOTSIO_YARPENCODERSPOLLER_H
+#define ROBOTSIO_YARPENCODERSPOLLER_H
+
+#include <Eigen/Dense>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <yarp/dev/IEncodersTimed.h>
+#include <yarp/os/PeriodicThread.h>
+#include <yarp/sig/Vector.h>
+
+namespace RobotsIO {
+    namespace Utils {
+        class YarpEncodersPoller;
+    }
+}
+
+
+/**
+ * Samples a set of encoders interfaces at a fixed rate and stores the readings, together with their timestamps,
+ * in a lock-free ring buffer. Readings of all the interfaces are concatenated in the order they are provided.
+ *
+ * The ring buffer has a single writer, the polling thread, and supports any number of concurrent readers.
+ */
+class RobotsIO::Utils::YarpEncodersPoller : public yarp::os::PeriodicThread
+{
+public:
+    YarpEncodersPoller(const std::vector<yarp::dev::IEncodersTimed*>& encoders, const double& period, const std::size_t& history_size = 256);
+
+    virtual ~YarpEncodersPoller();
+
+    /**
+     * Encoders linearly interpolated at the requested time.
+     *
+     * Requests older than the oldest sample in the history fail, while requests newer than the newest sample return the latter.
+     */
+    std::pair<bool, Eigen::VectorXd> encoders_at(const double& timestamp) const;
+
+    /**
+     * Newest sample and its timestamp.
+     */
+    std::tuple<bool, double, Eigen::VectorXd> latest_encoders() const;
+
+    /**
+     * Overloads writing into a caller-provided output, resized only if required, such that no allocations are performed in steady state.
+     */
+
+    bool encoders_at(const double& timestamp, Eigen::VectorXd& joints) const;
+
+    bool latest_encoders(double& timestamp, Eigen::VectorXd& joints) const;
+
+    std::size_t number_of_joints() const;
+
+protected:
+    void run() override;
+
+private:
+    bool read_sample(const std::uint64_t& sample, double& timestamp, Eigen::Ref<Eigen::VectorXd> joints) const;
+
+    std::vector<yarp::dev::IEncodersTimed*> encoders_;
+
+    std::vector<yarp::sig::Vector> readings_;
+
+    std::vector<yarp::sig::Vector> timestamps_;
+
+    std::size_t number_of_joints_ = 0;
+
+    /**
+     * Ring buffer.
+     *
+     * Each slot is protected by a sequence lock whose counter is odd while the slot is being written.
+     */
+
+    struct Slot
+    {
+        std::atomic<std::uint64_t> sequence;
+
+        std::atomic<std::uint64_t> sample;
+
+        std::atomic<double> timestamp;
+
+        std::unique_ptr<std::atomic<double>[]> joints;
+    };
+
+    const std::size_t history_size_;
+
+    std::unique_ptr<Slot[]> slots_;
+
+    std::atomic<std::uint64_t> written_;
+
+    /**
+     * Log name to be used in messages printed by the class.
+     */
+
+    const std::string log_name_ = "YarpEncodersPoller";
+};
+
+#endif /* ROBOTSIO_YARPENCODERSPOLLER_H */
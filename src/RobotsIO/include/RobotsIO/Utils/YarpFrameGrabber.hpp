@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef ROBOTSIO_YARPFRAMEGRABBER_H
+#define ROBOTSIO_YARPFRAMEGRABBER_H
+
+#include <RobotsIO/Utils/BufferPool.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include <yarp/os/BufferedPort.h>
+#include <yarp/os/Stamp.h>
+#include <yarp/os/TypedReaderCallback.h>
+
+namespace RobotsIO {
+    namespace Utils {
+        template<class T, class U>
+        class YarpFrameGrabber;
+    }
+}
+
+
+/**
+ * Keeps the newest frame received on a YARP port, using the port callback.
+ *
+ * Each frame is converted, from the type T of the port to the type U, in a buffer taken from a pool
+ * and handed out as an immutable reference counted buffer. A buffer is valid as long as it is referenced
+ * and it is recycled, without allocations, once released. Hence, the thread delivering the frames and the readers
+ * never wait on each other while copying a frame and frames can be safely shared across threads.
+ */
+template<class T, class U>
+class RobotsIO::Utils::YarpFrameGrabber : public yarp::os::TypedReaderCallback<T>
+{
+public:
+    struct Frame
+    {
+        std::shared_ptr<const U> data;
+
+        /* Increasing from 1 in order of arrival. */
+        std::uint64_t sequence = 0;
+
+        bool valid_timestamp = false;
+
+        double timestamp = 0.0;
+    };
+
+    typedef std::function<void(const T&, U&)> Conversion;
+
+    /**
+     * The optional predicate tells whether a buffer is referenced by other means than its std::shared_ptr (see BufferPool).
+     */
+    YarpFrameGrabber(yarp::os::BufferedPort<T>& port, const Conversion& conversion, const std::function<bool(const U&)>& is_referenced = nullptr);
+
+    virtual ~YarpFrameGrabber();
+
+    using yarp::os::TypedReaderCallback<T>::onRead;
+
+    void onRead(T& data) override;
+
+    /**
+     * The newest frame, if any, without waiting.
+     */
+    std::pair<bool, Frame> latest();
+
+    /**
+     * The newest frame, waiting until its sequence number is greater than the provided one
+     * or the timeout, in seconds, expires (a negative timeout waits indefinitely).
+     */
+    std::pair<bool, Frame> wait_newer(const std::uint64_t& sequence, const double& timeout = -1.0);
+
+    std::uint64_t sequence() const;
+
+    /**
+     * Listener invoked, on the thread delivering the frames, after each frame is received. An empty listener disables it.
+     *
+     * Once this returns, the previous listener is not running and is not invoked anymore, hence it can be safely destroyed.
+     * For the same reason, this should not be called from within the listener.
+     */
+    void set_listener(const std::function<void()>& listener);
+
+private:
+    yarp::os::BufferedPort<T>& port_;
+
+    Conversion conversion_;
+
+    RobotsIO::Utils::BufferPool<U> pool_;
+
+    /* Protected by the mutex. */
+    Frame latest_;
+
+    mutable std::mutex mutex_;
+
+    /* Held while the listener runs, such that set_listener() waits for calls in progress. */
+    std::function<void()> listener_;
+
+    std::mutex listener_mutex_;
+
+    std::condition_variable frame_received_;
+
+    const std::string log_name_ = "YarpFrameGrabber";
+};
+
+
+template<class T, class U>
+RobotsIO::Utils::YarpFrameGrabber<T, U>::YarpFrameGrabber(yarp::os::BufferedPort<T>& port, const Conversion& conversion, const std::function<bool(const U&)>& is_referenced) :
+    port_(port),
+    conversion_(conversion),
+    pool_(is_referenced)
+{
+    port_.useCallback(*this);
+}
+
+
+template<class T, class U>
+RobotsIO::Utils::YarpFrameGrabber<T, U>::~YarpFrameGrabber()
+{
+    port_.disableCallback();
+}
+
+
+template<class T, class U>
+void RobotsIO::Utils::YarpFrameGrabber<T, U>::onRead(T& data)
+{
+    std::shared_ptr<U> buffer = pool_.acquire();
+    conversion_(data, *buffer);
+
+    yarp::os::Stamp stamp;
+    const bool valid_timestamp = port_.getEnvelope(stamp) && stamp.isValid();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        latest_.data = buffer;
+        latest_.sequence++;
+        latest_.valid_timestamp = valid_timestamp;
+        latest_.timestamp = valid_timestamp ? stamp.getTime() : 0.0;
+    }
+
+    frame_received_.notify_all();
+
+    /* Readers of the frames are not blocked while the listener runs. */
+    std::lock_guard<std::mutex> lock(listener_mutex_);
+    if (listener_)
+        listener_();
+}
+
+
+template<class T, class U>
+std::pair<bool, typename RobotsIO::Utils::YarpFrameGrabber<T, U>::Frame> RobotsIO::Utils::YarpFrameGrabber<T, U>::latest()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    return std::make_pair(latest_.sequence > 0, latest_);
+}
+
+
+template<class T, class U>
+std::pair<bool, typename RobotsIO::Utils::YarpFrameGrabber<T, U>::Frame> RobotsIO::Utils::YarpFrameGrabber<T, U>::wait_newer(const std::uint64_t& sequence, const double& timeout)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    auto is_newer = [this, &sequence]() { return latest_.sequence > sequence; };
+
+    if (timeout < 0)
+        frame_received_.wait(lock, is_newer);
+    else if (!frame_received_.wait_for(lock, std::chrono::duration<double>(timeout), is_newer))
+        return std::make_pair(false, Frame());
+
+    return std::make_pair(true, latest_);
+}
+
+
+template<class T, class U>
+std::uint64_t RobotsIO::Utils::YarpFrameGrabber<T, U>::sequence() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    return latest_.sequence;
+}
+
+
+template<class T, class U>
+void RobotsIO::Utils::YarpFrameGrabber<T, U>::set_listener(const std::function<void()>& listener)
+{
+    std::lock_guard<std::mutex> lock(listener_mutex_);
+
+    listener_ = listener;
+}
+
+#endif /* ROBOTSIO_YARPFRAMEGRABBER_H */
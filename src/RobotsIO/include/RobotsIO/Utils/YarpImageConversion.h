@@ -0,0 +1,35 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef ROBOTSIO_YARPIMAGECONVERSION_H
+#define ROBOTSIO_YARPIMAGECONVERSION_H
+
+#include <Eigen/Dense>
+
+#include <opencv2/opencv.hpp>
+
+#include <yarp/sig/Image.h>
+
+namespace RobotsIO {
+    namespace Utils {
+        /**
+         * Conversions of YARP images into buffers that are reused if they already have the required size.
+         * Differently from yarp::cv::toCvMat(), the input is never modified.
+         */
+
+        void yarp_image_to_bgr(const yarp::sig::ImageOf<yarp::sig::PixelRgb>& image, cv::Mat& output);
+
+        void yarp_image_to_depth(const yarp::sig::ImageOf<yarp::sig::PixelFloat>& image, Eigen::MatrixXf& output);
+
+        /**
+         * Whether the memory of the image is shared with other cv::Mat headers.
+         */
+        bool is_mat_shared(const cv::Mat& image);
+    }
+}
+
+#endif /* ROBOTSIO_YARPIMAGECONVERSION_H */
@@ -8,14 +8,14 @@
 #ifndef ROBOTSIO_YARPIMAGEOFPROBE_H
 #define ROBOTSIO_YARPIMAGEOFPROBE_H
 
-#include <RobotsIO/Utils/Data.h>
-#include <RobotsIO/Utils/Probe.h>
+#include <RobotsIO/Utils/TypedProbe.hpp>
 #include <RobotsIO/Utils/YarpBufferedPort.hpp>
-#include <RobotsIO/Utils/any.h>
 
+#include <opencv2/opencv.hpp>
+
+#include <stdexcept>
 #include <string>
 
-#include <yarp/cv/Cv.h>
 #include <yarp/sig/Image.h>
 
 namespace RobotsIO {
@@ -28,7 +28,7 @@ namespace RobotsIO {
 
 template <class T>
 class RobotsIO::Utils::YarpImageOfProbe : public RobotsIO::Utils::YarpBufferedPort<yarp::sig::ImageOf<T>>,
-                                          public RobotsIO::Utils::Probe
+                                          public RobotsIO::Utils::TypedProbe<cv::Mat>
 {
 public:
     YarpImageOfProbe(const std::string& port_name);
@@ -36,12 +36,19 @@ public:
     virtual ~YarpImageOfProbe();
 
 protected:
-    void on_new_data() override;
+    /**
+     * The image is converted directly into the buffer of the port, whose storage is reused as long as the size of the image does not change.
+     */
+    void on_new_typed_data(const cv::Mat& data) override;
 
 private:
-    cv::Mat data_cv_;
+    /**
+     * OpenCV type of the images matching the pixel type of the port, or -1 if there is none.
+     * For pixel types without a matching OpenCV type, only the size of the elements of the image is checked.
+     */
+    static int image_type();
 
-    yarp::sig::ImageOf<T> data_;
+    void copy_image(const cv::Mat& source, cv::Mat& destination);
 
     const std::string log_name_ = "YarpImageOfProbe";
 };
@@ -59,13 +66,113 @@ RobotsIO::Utils::YarpImageOfProbe<T>::~YarpImageOfProbe()
 
 
 template <class T>
-void RobotsIO::Utils::YarpImageOfProbe<T>::on_new_data()
+void RobotsIO::Utils::YarpImageOfProbe<T>::on_new_typed_data(const cv::Mat& data)
 {
-    data_cv_ = RobotsIO::Utils::any_cast<cv::Mat>(get_data());
+    const int type = image_type();
+    if (((type >= 0) && (data.type() != type)) || ((type < 0) && (data.elemSize() != sizeof(T))))
+        throw(std::runtime_error(log_name_ + "::on_new_typed_data. Error: the type of the image does not match the type of the port."));
+
+    yarp::sig::ImageOf<T>& image = this->port_.prepare();
+    image.resize(data.cols, data.rows);
+
+    /* Header sharing the storage of the buffer of the port. */
+    cv::Mat image_cv(data.rows, data.cols, data.type(), image.getRawImage(), image.getRowSize());
+    copy_image(data, image_cv);
+
+    this->port_.write();
+}
+
+
+template <class T>
+int RobotsIO::Utils::YarpImageOfProbe<T>::image_type()
+{
+    return -1;
+}
+
+
+template <>
+inline int RobotsIO::Utils::YarpImageOfProbe<yarp::sig::PixelMono>::image_type()
+{
+    return CV_8UC1;
+}
+
 
-    data_ = yarp::cv::fromCvMat<T>(data_cv_);
+template <>
+inline int RobotsIO::Utils::YarpImageOfProbe<yarp::sig::PixelMono16>::image_type()
+{
+    return CV_16UC1;
+}
+
+
+template <>
+inline int RobotsIO::Utils::YarpImageOfProbe<yarp::sig::PixelFloat>::image_type()
+{
+    return CV_32FC1;
+}
+
+
+template <>
+inline int RobotsIO::Utils::YarpImageOfProbe<yarp::sig::PixelRgb>::image_type()
+{
+    return CV_8UC3;
+}
+
+
+template <>
+inline int RobotsIO::Utils::YarpImageOfProbe<yarp::sig::PixelBgr>::image_type()
+{
+    return CV_8UC3;
+}
 
-    this->send_data(data_);
+
+template <>
+inline int RobotsIO::Utils::YarpImageOfProbe<yarp::sig::PixelRgba>::image_type()
+{
+    return CV_8UC4;
+}
+
+
+template <>
+inline int RobotsIO::Utils::YarpImageOfProbe<yarp::sig::PixelBgra>::image_type()
+{
+    return CV_8UC4;
+}
+
+
+template <>
+inline int RobotsIO::Utils::YarpImageOfProbe<yarp::sig::PixelRgbFloat>::image_type()
+{
+    return CV_32FC3;
+}
+
+
+template <class T>
+void RobotsIO::Utils::YarpImageOfProbe<T>::copy_image(const cv::Mat& source, cv::Mat& destination)
+{
+    source.copyTo(destination);
+}
+
+
+/* Images are stored in BGR(A) format within OpenCV, hence channels are swapped for RGB(A) ports. */
+
+template <>
+inline void RobotsIO::Utils::YarpImageOfProbe<yarp::sig::PixelRgb>::copy_image(const cv::Mat& source, cv::Mat& destination)
+{
+    cv::cvtColor(source, destination, cv::COLOR_BGR2RGB);
+}
+
+
+template <>
+inline void RobotsIO::Utils::YarpImageOfProbe<yarp::sig::PixelRgba>::copy_image(const cv::Mat& source, cv::Mat& destination)
+{
+    cv::cvtColor(source, destination, cv::COLOR_BGRA2RGBA);
+}
+
+
+template <>
+inline void RobotsIO::Utils::YarpImageOfProbe<yarp::sig::PixelRgbFloat>::copy_image(const cv::Mat& source, cv::Mat& destination)
+{
+    cv::cvtColor(source, destination, cv::COLOR_BGR2RGB);
 }
 
 
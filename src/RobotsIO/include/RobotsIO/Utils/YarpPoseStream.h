@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef ROBOTSIO_YARPPOSESTREAM_H
+#define ROBOTSIO_YARPPOSESTREAM_H
+
+#include <Eigen/Dense>
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <yarp/os/BufferedPort.h>
+#include <yarp/os/Network.h>
+#include <yarp/os/TypedReaderCallback.h>
+#include <yarp/sig/Vector.h>
+
+namespace RobotsIO {
+    namespace Utils {
+        class YarpPoseStream;
+    }
+}
+
+
+/**
+ * Keeps the most recent poses received on a YARP port, in the x-y-z-axis-angle format used by
+ * YarpVectorOfProbe<double, Eigen::Transform<double, 3, Eigen::Affine>>, stamped with the timestamps in their envelopes
+ * (or with their arrival time if not available).
+ *
+ * Poses are stored in a fixed size ring buffer such that queries never wait for new poses and take bounded time.
+ */
+class RobotsIO::Utils::YarpPoseStream : public yarp::os::TypedReaderCallback<yarp::sig::VectorOf<double>>
+{
+public:
+    YarpPoseStream(const std::string& port_name, const std::size_t& history_size = 64);
+
+    virtual ~YarpPoseStream();
+
+    using yarp::os::TypedReaderCallback<yarp::sig::VectorOf<double>>::onRead;
+
+    void onRead(yarp::sig::VectorOf<double>& data) override;
+
+    /**
+     * Pose interpolated at the given timestamp (linearly for the position and spherically for the orientation).
+     * Timestamps newer than the newest pose are mapped to the newest pose, while those older than the oldest pose are not valid.
+     */
+    std::pair<bool, Eigen::Transform<double, 3, Eigen::Affine>> pose_at(const double& timestamp) const;
+
+    std::pair<bool, Eigen::Transform<double, 3, Eigen::Affine>> latest_pose() const;
+
+private:
+    struct StampedPose
+    {
+        double timestamp;
+
+        Eigen::Vector3d position;
+
+        Eigen::Quaterniond orientation;
+    };
+
+    const StampedPose& at(const std::size_t& index) const;
+
+    Eigen::Transform<double, 3, Eigen::Affine> to_transform(const Eigen::Vector3d& position, const Eigen::Quaterniond& orientation) const;
+
+    yarp::os::Network yarp_;
+
+    yarp::os::BufferedPort<yarp::sig::VectorOf<double>> port_;
+
+    /* Protected by the mutex. */
+    std::vector<StampedPose, Eigen::aligned_allocator<StampedPose>> history_;
+
+    std::size_t head_ = 0;
+
+    std::size_t count_ = 0;
+
+    mutable std::mutex mutex_;
+
+    const std::string log_name_ = "YarpPoseStream";
+};
+
+#endif /* ROBOTSIO_YARPPOSESTREAM_H */
@@ -0,0 +1,34 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef ROBOTSIO_YARPVECTOROFBATCH_H
+#define ROBOTSIO_YARPVECTOROFBATCH_H
+
+#include <Eigen/Dense>
+
+#include <yarp/sig/Vector.h>
+
+namespace RobotsIO {
+    namespace Utils {
+        /**
+         * Batches of samples, as sent by YarpBatchedVectorOfProbe, are stored in a single yarp::sig::VectorOf<double> as
+         *
+         *     N M t_0 s_0(0) ... s_0(M - 1) ... t_(N - 1) s_(N - 1)(0) ... s_(N - 1)(M - 1)
+         *
+         * where N is the number of samples, M is the size of each sample, t_i is the timestamp of the i-th sample,
+         * in seconds, and s_i is the i-th sample.
+         */
+
+        /**
+         * Unpacks a batch into the timestamps and the samples, stored as columns.
+         * Outputs are resized only if required. Returns false if the message is not a valid batch.
+         */
+        bool unpack_vector_of_batch(const yarp::sig::VectorOf<double>& batch, Eigen::VectorXd& timestamps, Eigen::MatrixXd& samples);
+    }
+}
+
+#endif /* ROBOTSIO_YARPVECTOROFBATCH_H */
@@ -10,27 +10,87 @@
 
 #include <Eigen/Dense>
 
-#include <RobotsIO/Utils/Data.h>
-#include <RobotsIO/Utils/Probe.h>
+#include <RobotsIO/Utils/TypedProbe.hpp>
 #include <RobotsIO/Utils/YarpBufferedPort.hpp>
-#include <RobotsIO/Utils/any.h>
 
 #include <string>
 
-#include <yarp/eigen/Eigen.h>
 #include <yarp/sig/Vector.h>
 
 namespace RobotsIO {
     namespace Utils {
+        template <class T, class U>
+        struct YarpVectorOfConversion;
+
         template <class T, class U = yarp::sig::VectorOf<T>>
         class YarpVectorOfProbe;
     }
 }
 
 
+/**
+ * Conversion from data of type U to a yarp::sig::VectorOf<T>.
+ *
+ * The output is resized only if required, such that its storage is reused.
+ * Support for other types is added by specializing this class with a static member
+ *
+ *     static void convert(const U& data, yarp::sig::VectorOf<T>& output);
+ */
+template <class T, class U>
+struct RobotsIO::Utils::YarpVectorOfConversion
+{
+    static void convert(const U& data, yarp::sig::VectorOf<T>& output)
+    {
+        output = data;
+    }
+};
+
+
+/**
+ * Eigen vectors and matrices, either fixed-size or dynamic, stored in column-major order.
+ */
+template <class T, int Rows, int Cols, int Options, int MaxRows, int MaxCols>
+struct RobotsIO::Utils::YarpVectorOfConversion<T, Eigen::Matrix<T, Rows, Cols, Options, MaxRows, MaxCols>>
+{
+    static void convert(const Eigen::Matrix<T, Rows, Cols, Options, MaxRows, MaxCols>& data, yarp::sig::VectorOf<T>& output)
+    {
+        if (output.size() != static_cast<std::size_t>(data.size()))
+            output.resize(data.size());
+
+        Eigen::Map<Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>>(output.data(), data.rows(), data.cols()) = data;
+    }
+};
+
+
+/**
+ * Quaternions, stored as x-y-z-w.
+ */
+template <class T>
+struct RobotsIO::Utils::YarpVectorOfConversion<T, Eigen::Quaternion<T>>
+{
+    static void convert(const Eigen::Quaternion<T>& data, yarp::sig::VectorOf<T>& output)
+    {
+        if (output.size() != 4)
+            output.resize(4);
+
+        Eigen::Map<Eigen::Matrix<T, 4, 1>>(output.data()) = data.coeffs();
+    }
+};
+
+
+/**
+ * Transformations, stored as x-y-z-axis-angle.
+ */
+template <>
+struct RobotsIO::Utils::YarpVectorOfConversion<double, Eigen::Transform<double, 3, Eigen::Affine>>
+{
+    static void convert(const Eigen::Transform<double, 3, Eigen::Affine>& data, yarp::sig::VectorOf<double>& output);
+};
+
+
 template <class T, class U>
 class RobotsIO::Utils::YarpVectorOfProbe : public RobotsIO::Utils::YarpBufferedPort<yarp::sig::VectorOf<T>>,
-                                           public RobotsIO::Utils::Probe
+                                           public RobotsIO::Utils::TypedProbe<U>
 {
 public:
     YarpVectorOfProbe(const std::string& port_name);
@@ -38,13 +98,12 @@ public:
     virtual ~YarpVectorOfProbe();
 
 protected:
-    void on_new_data() override;
+    /**
+     * The data is converted, using YarpVectorOfConversion, directly into the buffer of the port.
+     */
+    void on_new_typed_data(const U& data) override;
 
 private:
-    yarp::sig::VectorOf<T> convert_from(const U& data);
-
-    yarp::sig::VectorOf<T> data_;
-
     const std::string log_name_ = "YarpVectorOfProbe";
 };
 
@@ -61,26 +120,11 @@ RobotsIO::Utils::YarpVectorOfProbe<T, U>::~YarpVectorOfProbe()
 
 
 template <class T, class U>
-void RobotsIO::Utils::YarpVectorOfProbe<T, U>::on_new_data()
+void RobotsIO::Utils::YarpVectorOfProbe<T, U>::on_new_typed_data(const U& data)
 {
-    data_ = convert_from(RobotsIO::Utils::any_cast<U>(get_data()));
+    RobotsIO::Utils::YarpVectorOfConversion<T, U>::convert(data, this->port_.prepare());
 
-    this->send_data(data_);
+    this->port_.write();
 }
 
-
-template <class T, class U>
-yarp::sig::VectorOf<T> RobotsIO::Utils::YarpVectorOfProbe<T, U>::convert_from(const U& data)
-{
-    return data;
-}
-
-
-template <>
-yarp::sig::VectorOf<double> RobotsIO::Utils::YarpVectorOfProbe<double, Eigen::VectorXd>::convert_from(const Eigen::VectorXd& data);
-
-
-template <>
-yarp::sig::VectorOf<double> RobotsIO::Utils::YarpVectorOfProbe<double, Eigen::Transform<double, 3, Eigen::Affine>>::convert_from(const Eigen::Transform<double, 3, Eigen::Affine>& data);
-
 #endif /* ROBOTSIO_YARPVECTOROFPROBE_H */
@@ -52,10 +52,13 @@
 #define ROBOTSIO_ANY_H
 
 #include <algorithm>
+#include <cstddef>
 #include <memory>
+#include <new>
 #include <stdexcept>
 #include <typeinfo>
 #include <type_traits>
+#include <utility>
 
 
 namespace RobotsIO
@@ -79,7 +82,8 @@ public:
      * Constructs an empty object.
      */
     any() noexcept :
-        content(0)
+        content(0),
+        in_buffer(false)
     { }
 
 
@@ -89,8 +93,11 @@ public:
      * or empty if other is empty.
      */
     any(const any& other) :
-        content(other.content ? other.content->clone() : 0)
-    { }
+        content(0),
+        in_buffer(false)
+    {
+        copy_from(other);
+    }
 
 
     /**
@@ -99,9 +106,10 @@ public:
      * or empty if other is empty.
      */
     any(any&& other) noexcept :
-        content(other.content)
+        content(0),
+        in_buffer(false)
     {
-        other.content = 0;
+        move_from(other);
     }
 
 
@@ -112,8 +120,11 @@ public:
      */
     template<typename ValueType>
     any(const ValueType& value) :
-        content(new holder<typename std::remove_cv<typename std::decay<const ValueType>::type>::type>(value))
-    { }
+        content(0),
+        in_buffer(false)
+    {
+        create<typename std::remove_cv<typename std::decay<const ValueType>::type>::type>(value);
+    }
 
 
     /**
@@ -123,8 +134,11 @@ public:
      */
     template<typename ValueType>
     any(ValueType&& value, typename std::enable_if<!std::is_same<any&, ValueType>::value>::type* = 0, typename std::enable_if<!std::is_const<ValueType>::value>::type* = 0) :
-        content(new holder<typename std::decay<ValueType>::type>(static_cast<ValueType&&>(value)))
-    { }
+        content(0),
+        in_buffer(false)
+    {
+        create<typename std::decay<ValueType>::type>(static_cast<ValueType&&>(value));
+    }
 
 
     /**
@@ -132,13 +146,14 @@ public:
      */
     ~any() noexcept
     {
-        delete content;
+        destroy();
     }
 
 
     /**
      * Assigns contents to the contained value.
      * Assigns by copying the state of rhs, as if by any(rhs).swap(*this).
+     * Should copying throw, the contained value is left unchanged.
      *
      * @param rhs object whose contained value to assign
      */
@@ -158,8 +173,11 @@ public:
      */
     any& operator=(any&& rhs) noexcept
     {
-        rhs.swap(*this);
-        any().swap(rhs);
+        if (this != &rhs)
+        {
+            destroy();
+            move_from(rhs);
+        }
         return *this;
     }
 
@@ -173,19 +191,39 @@ public:
      * @param rhs object whose contained value to assign
      */
     template <class ValueType>
-    any& operator=(ValueType&& rhs)
+    typename std::enable_if<!std::is_same<any, typename std::decay<ValueType>::type>::value, any&>::type operator=(ValueType&& rhs)
     {
         any(static_cast<ValueType&&>(rhs)).swap(*this);
         return *this;
     }
 
 
+    /**
+     * Changes the contained object to one of type std::decay_t<ValueType> constructed from the arguments.
+     * First destroys the current contained object (if any) by reset(), then constructs the new one in place.
+     *
+     * @param args arguments to be passed to the constructor of the contained object
+     *
+     * @return A reference to the new contained object.
+     */
+    template<typename ValueType, typename... Args>
+    typename std::decay<ValueType>::type& emplace(Args&&... args)
+    {
+        typedef typename std::decay<ValueType>::type value_type;
+
+        reset();
+        create<value_type>(std::forward<Args>(args)...);
+
+        return static_cast<holder<value_type>*>(content)->held;
+    }
+
+
     /**
      * If not empty, destroys the contained object.
      */
     void reset() noexcept
     {
-        any().swap(*this);
+        destroy();
     }
 
 
@@ -196,7 +234,20 @@ public:
      */
     any& swap(any& rhs) noexcept
     {
-        std::swap(content, rhs.content);
+        if (this == &rhs)
+            return *this;
+
+        if (!in_buffer && !rhs.in_buffer)
+        {
+            std::swap(content, rhs.content);
+            return *this;
+        }
+
+        /* Contents stored in the small buffer are moved across buffers. */
+        any tmp(static_cast<any&&>(rhs));
+        rhs.move_from(*this);
+        move_from(tmp);
+
         return *this;
     }
 
@@ -234,6 +285,9 @@ private:
 
         virtual placeholder* clone() const = 0;
 
+        virtual placeholder* clone_into(void* buffer) const = 0;
+
+        virtual placeholder* move_into(void* buffer) noexcept = 0;
     };
 
 
@@ -241,13 +295,9 @@ private:
     class holder : public placeholder
     {
     public:
-        holder(const ValueType& value) :
-          held(value)
-        { }
-
-
-        holder(ValueType&& value) :
-          held(static_cast<ValueType&&>(value))
+        template<typename... Args>
+        holder(Args&&... args) :
+          held(std::forward<Args>(args)...)
         { }
 
 
@@ -263,6 +313,18 @@ private:
         }
 
 
+        virtual placeholder* clone_into(void* buffer) const
+        {
+            return new (buffer) holder(held);
+        }
+
+
+        virtual placeholder* move_into(void* buffer) noexcept
+        {
+            return new (buffer) holder(static_cast<ValueType&&>(held));
+        }
+
+
         ValueType held;
 
     private:
@@ -270,11 +332,106 @@ private:
     };
 
 
+    /**
+     * Small contents are stored within the object, avoiding dynamic allocations.
+     * The buffer is sized for fixed-size Eigen types up to a 4x4 matrix of doubles, e.g. Eigen::Transform<double, 3, Eigen::Affine>.
+     * Types that cannot be moved without exceptions are always allocated dynamically, such that moving any never throws.
+     *
+     * The buffer makes sizeof(any) grow from 8 to 160 bytes on 64-bit platforms, for every instance,
+     * including the Data held by each Probe, regardless of the size of the contained object.
+     */
+    static constexpr std::size_t small_buffer_alignment = alignof(std::max_align_t);
+
+    static constexpr std::size_t small_buffer_size = 16 * sizeof(double) + small_buffer_alignment;
+
+    template<typename ValueType>
+    struct is_small : std::integral_constant<bool,
+                                             (sizeof(holder<ValueType>) <= small_buffer_size) &&
+                                             (alignof(holder<ValueType>) <= small_buffer_alignment) &&
+                                             std::is_nothrow_move_constructible<ValueType>::value>
+    { };
+
+
+    template<typename ValueType, typename... Args>
+    void create(Args&&... args)
+    {
+        construct<ValueType>(typename is_small<ValueType>::type(), std::forward<Args>(args)...);
+    }
+
+
+    template<typename ValueType, typename... Args>
+    void construct(std::true_type, Args&&... args)
+    {
+        content = new (&buffer) holder<ValueType>(std::forward<Args>(args)...);
+        in_buffer = true;
+    }
+
+
+    template<typename ValueType, typename... Args>
+    void construct(std::false_type, Args&&... args)
+    {
+        content = new holder<ValueType>(std::forward<Args>(args)...);
+        in_buffer = false;
+    }
+
+
+    /* The following require the object to be empty. */
+
+    void copy_from(const any& other)
+    {
+        if (!other.content)
+            return;
+
+        if (other.in_buffer)
+        {
+            content = other.content->clone_into(&buffer);
+            in_buffer = true;
+        }
+        else
+            content = other.content->clone();
+    }
+
+
+    void move_from(any& other) noexcept
+    {
+        if (!other.content)
+            return;
+
+        if (other.in_buffer)
+        {
+            content = other.content->move_into(&buffer);
+            in_buffer = true;
+            other.destroy();
+        }
+        else
+        {
+            content = other.content;
+            other.content = 0;
+        }
+    }
+
+
+    void destroy() noexcept
+    {
+        if (in_buffer)
+            content->~placeholder();
+        else
+            delete content;
+
+        content = 0;
+        in_buffer = false;
+    }
+
+
 private:
     template<typename ValueType>
     friend ValueType* any_cast(any*) noexcept;
 
     placeholder* content;
+
+    bool in_buffer;
+
+    typename std::aligned_storage<small_buffer_size, small_buffer_alignment>::type buffer;
 };
 
 
@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#include <RobotsIO/Camera/CalibrationLookupGrid.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+using namespace Eigen;
+using namespace RobotsIO::Camera;
+
+
+CalibrationLookupGrid::CalibrationLookupGrid
+(
+    const Model& model,
+    const Vector3d& lower_bounds,
+    const Vector3d& upper_bounds,
+    const Vector3i& resolution,
+    const double& translation_error_bound,
+    const double& rotation_error_bound,
+    const std::size_t& validation_samples
+) :
+    model_(model),
+    lower_bounds_(lower_bounds),
+    upper_bounds_(upper_bounds),
+    resolution_(resolution)
+{
+    if ((resolution_.array() < 2).any())
+        throw(std::runtime_error(log_name_ + "::ctor. Error: the grid requires at least two nodes per dimension."));
+
+    if ((upper_bounds_.array() <= lower_bounds_.array()).any())
+        throw(std::runtime_error(log_name_ + "::ctor. Error: upper bounds should be greater than lower bounds."));
+
+    step_ = (upper_bounds_ - lower_bounds_).array() / (resolution_.cast<double>().array() - 1.0);
+
+    const std::size_t number_of_nodes = resolution_.prod();
+    nodes_.resize(number_of_nodes);
+    evaluated_.resize(number_of_nodes, false);
+
+    report_ = validate(validation_samples);
+    within_error_bounds_ = (report_.max_translation_error <= translation_error_bound) && (report_.max_rotation_error <= rotation_error_bound);
+}
+
+
+CalibrationLookupGrid::Vector6d CalibrationLookupGrid::predict(const Vector3d& input)
+{
+    if (within_error_bounds_ && is_inside(input))
+        return interpolate(input);
+
+    return model_(input);
+}
+
+
+bool CalibrationLookupGrid::is_within_error_bounds() const
+{
+    return within_error_bounds_;
+}
+
+
+CalibrationLookupGrid::Report CalibrationLookupGrid::report() const
+{
+    return report_;
+}
+
+
+bool CalibrationLookupGrid::is_inside(const Vector3d& input) const
+{
+    return (input.array() >= lower_bounds_.array()).all() && (input.array() <= upper_bounds_.array()).all();
+}
+
+
+CalibrationLookupGrid::Vector6d CalibrationLookupGrid::interpolate(const Vector3d& input)
+{
+    /* Find the cell containing the input and the local coordinates within it. */
+    int index[3];
+    double t[3];
+    for (std::size_t d = 0; d < 3; d++)
+    {
+        const double coordinate = (input(d) - lower_bounds_(d)) / step_(d);
+        index[d] = std::min(std::max(int(std::floor(coordinate)), 0), resolution_(d) - 2);
+        t[d] = coordinate - index[d];
+    }
+
+    /* Trilinear interpolation. */
+    Vector6d output = Vector6d::Zero();
+    for (int di = 0; di < 2; di++)
+        for (int dj = 0; dj < 2; dj++)
+            for (int dk = 0; dk < 2; dk++)
+            {
+                const double weight = (di ? t[0] : 1.0 - t[0]) * (dj ? t[1] : 1.0 - t[1]) * (dk ? t[2] : 1.0 - t[2]);
+                output += weight * node(index[0] + di, index[1] + dj, index[2] + dk);
+            }
+
+    return output;
+}
+
+
+const CalibrationLookupGrid::Vector6d& CalibrationLookupGrid::node(const int& i, const int& j, const int& k)
+{
+    const std::size_t index = (std::size_t(k) * resolution_(1) + j) * resolution_(0) + i;
+
+    if (!evaluated_[index])
+    {
+        const Vector3d input = lower_bounds_ + Vector3d(i, j, k).cwiseProduct(step_);
+        nodes_[index] = model_(input);
+        evaluated_[index] = true;
+    }
+
+    return nodes_[index];
+}
+
+
+CalibrationLookupGrid::Report CalibrationLookupGrid::validate(const std::size_t& samples)
+{
+    Report report;
+    report.samples = samples;
+    if (samples == 0)
+        return report;
+
+    /* Random inputs within the bounds, using a fixed seed such that the report is reproducible. */
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::vector<Vector3d, aligned_allocator<Vector3d>> inputs(samples);
+    for (auto& input : inputs)
+        for (std::size_t d = 0; d < 3; d++)
+            input(d) = lower_bounds_(d) + uniform(generator) * (upper_bounds_(d) - lower_bounds_(d));
+
+    /* Accuracy. */
+    std::vector<Vector6d, aligned_allocator<Vector6d>> expected(samples);
+    for (std::size_t i = 0; i < samples; i++)
+    {
+        expected[i] = model_(inputs[i]);
+        const Vector6d error = interpolate(inputs[i]) - expected[i];
+
+        const double translation_error = error.head<3>().norm();
+        const double rotation_error = error.tail<3>().norm();
+
+        report.max_translation_error = std::max(report.max_translation_error, translation_error);
+        report.max_rotation_error = std::max(report.max_rotation_error, rotation_error);
+        report.mean_translation_error += translation_error / samples;
+        report.mean_rotation_error += rotation_error / samples;
+    }
+
+    /* Latency, once the nodes involved are already memoized. */
+    Vector6d sink = Vector6d::Zero();
+
+    auto model_begin = std::chrono::steady_clock::now();
+    for (const auto& input : inputs)
+        sink += model_(input);
+    auto model_end = std::chrono::steady_clock::now();
+
+    auto grid_begin = std::chrono::steady_clock::now();
+    for (const auto& input : inputs)
+        sink += interpolate(input);
+    auto grid_end = std::chrono::steady_clock::now();
+
+    report.model_latency = std::chrono::duration<double>(model_end - model_begin).count() / samples;
+    report.grid_latency = std::chrono::duration<double>(grid_end - grid_begin).count() / samples;
+
+    /* Prevent the optimizer from discarding the timed loops. */
+    volatile double sink_norm = sink.norm();
+    (void) sink_norm;
+
+    return report;
+}
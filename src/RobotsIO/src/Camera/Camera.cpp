@@ -66,39 +66,110 @@ std::pair<bool, Eigen::MatrixXd> Camera::point_cloud
     const bool& blocking,
     const double& maximum_depth,
     const bool& use_root_frame,
-    const bool& enable_colors
+    const bool& enable_colors,
+    const bool& use_confidence
 )
 {
-    /* Get rgb, if required. */
+    bool valid_cloud = false;
+    std::size_t number_points = 0;
+    Transform<double, 3, Affine> camera_pose;
+    std::tie(valid_cloud, number_points) = point_cloud_valid_points(blocking, maximum_depth, use_root_frame, enable_colors, use_confidence, camera_pose);
+    if (!valid_cloud)
+        return std::make_pair(false, MatrixXd());
+
+    /* The output is allocated once, having exactly one column per point. */
+    MatrixXd cloud(enable_colors ? 6 : 3, number_points);
+    point_cloud_fill(cloud, camera_pose, use_root_frame, enable_colors);
+
+    return std::make_pair(true, std::move(cloud));
+}
+
+
+std::pair<bool, std::size_t> Camera::point_cloud
+(
+    const bool& blocking,
+    MatrixXd& cloud,
+    const double& maximum_depth,
+    const bool& use_root_frame,
+    const bool& enable_colors,
+    const bool& use_confidence
+)
+{
+    bool valid_cloud = false;
+    std::size_t number_points = 0;
+    Transform<double, 3, Affine> camera_pose;
+    std::tie(valid_cloud, number_points) = point_cloud_valid_points(blocking, maximum_depth, use_root_frame, enable_colors, use_confidence, camera_pose);
+    if (!valid_cloud)
+        return std::make_pair(false, 0);
+
+    /* The output is resized only if too small, to the maximum number of points, such that it is not resized again. */
+    const std::size_t number_rows = enable_colors ? 6 : 3;
+    if ((std::size_t(cloud.rows()) != number_rows) || (std::size_t(cloud.cols()) < number_points))
+        cloud.resize(number_rows, parameters_.height * parameters_.width);
+
+    point_cloud_fill(cloud, camera_pose, use_root_frame, enable_colors);
+
+    return std::make_pair(true, number_points);
+}
+
+
+bool Camera::depth(const bool& blocking, MatrixXf& depth)
+{
+    bool valid_depth = false;
+    std::tie(valid_depth, depth) = this->depth(blocking);
+
+    return valid_depth;
+}
+
+
+bool Camera::depth_with_confidence(const bool& blocking, MatrixXf& depth, MatrixXf& confidence)
+{
+    bool valid_depth = false;
+    std::tie(valid_depth, depth, confidence) = this->depth_with_confidence(blocking);
+
+    return valid_depth;
+}
+
+
+bool Camera::rgb(const bool& blocking, cv::Mat& rgb)
+{
     bool valid_rgb = false;
-    cv::Mat rgb;
-    if (enable_colors)
-    {
-        std::tie(valid_rgb, rgb) = this->rgb(blocking);
-        if (!valid_rgb)
-            return std::make_pair(false, MatrixXd());
-    }
+    std::tie(valid_rgb, rgb) = this->rgb(blocking);
+
+    return valid_rgb;
+}
 
-    /* Get depth. */
+
+std::tuple<bool, MatrixXf, MatrixXf> Camera::depth_with_confidence(const bool& blocking)
+{
     bool valid_depth = false;
     MatrixXf depth;
     std::tie(valid_depth, depth) = this->depth(blocking);
-    if (!valid_depth)
-        return std::make_pair(false, MatrixXd());
 
+    return std::make_tuple(valid_depth, depth, MatrixXf());
+}
 
-    /* Get pose, if required. */
-    bool valid_pose = false;
-    Transform<double, 3, Affine> camera_pose;
-    if (use_root_frame)
-    {
-        std::tie(valid_pose, camera_pose) = this->pose(blocking);
-        if (!valid_pose)
-            return std::make_pair(false, MatrixXd());
-    }
 
-    /* Find 3D points having positive and less than max_depth_ depth. */
-    MatrixXi valid_points(parameters_.height, parameters_.width);
+std::pair<bool, std::size_t> Camera::point_cloud_valid_points
+(
+    const bool& blocking,
+    const double& maximum_depth,
+    const bool& use_root_frame,
+    const bool& enable_colors,
+    const bool& use_confidence,
+    Transform<double, 3, Affine>& camera_pose
+)
+{
+    if (!point_cloud_data(blocking, use_root_frame, enable_colors, use_confidence, camera_pose))
+        return std::make_pair(false, 0);
+    const bool filter_confidence = use_confidence && (point_cloud_confidence_.size() != 0);
+
+    const MatrixXf& depth = point_cloud_depth_;
+    const MatrixXf& confidence = point_cloud_confidence_;
+
+    /* Find 3D points having positive and less than max_depth_ depth and, if required, a non-zero confidence. */
+    MatrixXi& valid_points = point_cloud_valid_points_;
+    valid_points.resize(parameters_.height, parameters_.width);
 #pragma omp parallel for collapse(2)
     for (std::size_t v = 0; v < parameters_.height; v++)
     {
@@ -106,6 +177,9 @@ std::pair<bool, Eigen::MatrixXd> Camera::point_cloud
         {
             valid_points(v, u) = 0;
 
+            if (filter_confidence && (confidence(v, u) <= 0))
+                continue;
+
             float depth_u_v = depth(v, u);
 
             if ((depth_u_v > 0) && (depth_u_v < maximum_depth))
@@ -115,18 +189,66 @@ std::pair<bool, Eigen::MatrixXd> Camera::point_cloud
     const std::size_t number_valids = valid_points.sum();
 
     if (number_valids == 0)
-        return std::make_pair(false, MatrixXd());
+        return std::make_pair(false, 0);
 
-    /* Get deprojection matrix. */
-    bool valid_deprojection_matrix = false;
-    MatrixXd deprojection_matrix;
-    std::tie(valid_deprojection_matrix, deprojection_matrix) = this->deprojection_matrix();
-    if (!valid_deprojection_matrix)
-        return std::make_pair(false, MatrixXd());
+    /* Get deprojection matrix, which does not change once the camera is initialized. */
+    if (point_cloud_deprojection_matrix_.size() == 0)
+    {
+        bool valid_deprojection_matrix = false;
+        std::tie(valid_deprojection_matrix, point_cloud_deprojection_matrix_) = this->deprojection_matrix();
+        if (!valid_deprojection_matrix)
+            return std::make_pair(false, 0);
+    }
+
+    return std::make_pair(true, number_valids);
+}
+
+
+bool Camera::point_cloud_data
+(
+    const bool& blocking,
+    const bool& use_root_frame,
+    const bool& enable_colors,
+    const bool& use_confidence,
+    Transform<double, 3, Affine>& camera_pose
+)
+{
+    /* Get rgb, if required. */
+    if (enable_colors)
+    {
+        if (!this->rgb(blocking, point_cloud_rgb_))
+            return false;
+    }
+
+    /* Get depth and, if required, the associated confidence map. */
+    bool valid_depth = false;
+    if (use_confidence)
+        valid_depth = this->depth_with_confidence(blocking, point_cloud_depth_, point_cloud_confidence_);
+    else
+        valid_depth = this->depth(blocking, point_cloud_depth_);
+    if (!valid_depth)
+        return false;
+
+    /* Get pose, if required. */
+    if (use_root_frame)
+    {
+        bool valid_pose = false;
+        std::tie(valid_pose, camera_pose) = this->pose(blocking);
+        if (!valid_pose)
+            return false;
+    }
+
+    return true;
+}
+
+
+void Camera::point_cloud_fill(MatrixXd& cloud, const Transform<double, 3, Affine>& camera_pose, const bool& use_root_frame, const bool& enable_colors)
+{
+    const MatrixXf& depth = point_cloud_depth_;
+    const cv::Mat& rgb = point_cloud_rgb_;
+    const MatrixXi& valid_points = point_cloud_valid_points_;
+    const MatrixXd& deprojection_matrix = point_cloud_deprojection_matrix_;
 
-    /* Store points in the output matrix. */
-    const std::size_t number_rows = enable_colors ? 6 : 3;
-    MatrixXd cloud(number_rows, number_valids);
     std::size_t counter = 0;
     for (std::size_t v = 0; v < parameters_.height; v++)
         for (std::size_t u = 0; u < parameters_.width; u++)
@@ -150,9 +272,52 @@ std::pair<bool, Eigen::MatrixXd> Camera::point_cloud
 
     /* Express taking into account the camera pose, if required. */
     if (use_root_frame)
-        cloud.topRows<3>() = camera_pose * cloud.topRows<3>().colwise().homogeneous();
+    {
+        for (std::size_t i = 0; i < counter; i++)
+        {
+            const Vector3d point = cloud.col(i).head<3>();
+            cloud.col(i).head<3>() = camera_pose * point;
+        }
+    }
+}
 
-    return std::make_pair(true, cloud);
+
+std::pair<bool, Camera::Frame> Camera::frame(const bool& blocking, const bool& enable_depth)
+{
+    Frame frame;
+
+    bool valid_rgb = false;
+    std::tie(valid_rgb, frame.rgb) = rgb(blocking);
+    if (!valid_rgb)
+        return std::make_pair(false, Frame());
+
+    if (enable_depth)
+    {
+        bool valid_depth = false;
+        std::tie(valid_depth, frame.depth) = depth(blocking);
+        if (!valid_depth)
+            return std::make_pair(false, Frame());
+    }
+
+    bool valid_pose = false;
+    std::tie(valid_pose, frame.pose) = pose(blocking);
+    if (!valid_pose)
+        return std::make_pair(false, Frame());
+
+    bool valid_auxiliary_data = false;
+    std::tie(valid_auxiliary_data, frame.auxiliary_data) = auxiliary_data(blocking);
+    if (!valid_auxiliary_data)
+        frame.auxiliary_data = VectorXd();
+
+    frame.sequence = is_offline() ? std::uint64_t(frame_index_) : ++frame_sequence_;
+
+    return std::make_pair(true, frame);
+}
+
+
+bool Camera::set_frame_listener(const std::function<void()>& listener)
+{
+    return false;
 }
 
 
@@ -375,6 +540,15 @@ Camera::Camera
 
 
 std::pair<bool, MatrixXf> Camera::depth_offline()
+{
+    MatrixXf depth;
+    const bool valid_depth = depth_offline(depth);
+
+    return std::make_pair(valid_depth, std::move(depth));
+}
+
+
+bool Camera::depth_offline(MatrixXf& depth)
 {
     std::FILE* in;
     const std::string file_name = data_path_ + "depth_" + std::to_string(frame_index_) + ".float";
@@ -382,26 +556,32 @@ std::pair<bool, MatrixXf> Camera::depth_offline()
     if ((in = std::fopen(file_name.c_str(), "rb")) == nullptr)
     {
         std::cout << log_name_ << "::depth_offline. Error: cannot load depth frame " + file_name;
-        return std::make_pair(true, MatrixXf());
+        depth.resize(0, 0);
+        return true;
     }
 
     /* Load image size .*/
     std::size_t dims[2];
     if (std::fread(dims, sizeof(dims), 1, in) != 1)
-        return std::make_pair(false, MatrixXf());
-
-    /* Load image. */
-    float float_image_raw[dims[0] * dims[1]];
-    if (std::fread(float_image_raw, sizeof(float), dims[0] * dims[1], in) != dims[0] * dims[1])
-        return std::make_pair(false, MatrixXf());
+    {
+        std::fclose(in);
+        return false;
+    }
 
-    /* Store image. */
-    MatrixXf float_image(dims[1], dims[0]);
-    float_image = Map<Matrix<float, -1, -1, RowMajor>>(float_image_raw, dims[1], dims[0]);
+    /* Load image, stored row-major, in a buffer reused across frames. */
+    depth_offline_buffer_.resize(dims[1], dims[0]);
+    if (std::fread(depth_offline_buffer_.data(), sizeof(float), dims[0] * dims[1], in) != dims[0] * dims[1])
+    {
+        std::fclose(in);
+        return false;
+    }
 
     std::fclose(in);
 
-    return std::make_pair(true, float_image);
+    /* Store image. */
+    depth = depth_offline_buffer_;
+
+    return true;
 }
 
 
@@ -0,0 +1,286 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#include <RobotsIO/Camera/CameraEventLoop.h>
+
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+
+using namespace RobotsIO::Camera;
+
+
+CameraEventLoop::CameraEventLoop(RobotsIO::Camera::Camera& camera, const bool& enable_depth) :
+    camera_(camera),
+    enable_depth_(enable_depth),
+    failures_(0)
+{
+    if (camera_.is_offline())
+        thread_ = std::thread(&CameraEventLoop::run_offline, this);
+    else
+    {
+        if (!camera_.set_frame_listener(std::bind(&CameraEventLoop::notify_frame_received, this)))
+            throw(std::runtime_error(log_name_ + "::ctor. Error: the camera does not notify the reception of new frames."));
+
+        thread_ = std::thread(&CameraEventLoop::run, this);
+    }
+}
+
+
+CameraEventLoop::~CameraEventLoop()
+{
+    stop();
+}
+
+
+std::size_t CameraEventLoop::add_callback(const Callback& callback)
+{
+    std::size_t id;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        on_new_demand();
+
+        id = next_callback_id_++;
+        callbacks_[id] = callback;
+    }
+    condition_.notify_all();
+
+    return id;
+}
+
+
+bool CameraEventLoop::remove_callback(const std::size_t& id)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    return callbacks_.erase(id) > 0;
+}
+
+
+std::future<CameraEventLoop::FrameHandle> CameraEventLoop::next_frame()
+{
+    std::promise<FrameHandle> promise;
+    std::future<FrameHandle> future = promise.get_future();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (running_)
+        {
+            on_new_demand();
+
+            promises_.push_back(std::move(promise));
+        }
+        else
+            promise.set_value(FrameHandle());
+    }
+    condition_.notify_all();
+
+    return future;
+}
+
+
+void CameraEventLoop::stop()
+{
+    /* Remove the listener first, without holding the mutex, as the camera waits for the calls in progress,
+       which lock the mutex, to complete. Afterwards, the camera does not reference this object anymore. */
+    if (!camera_.is_offline())
+        camera_.set_frame_listener(nullptr);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (!running_ && !thread_.joinable())
+            return;
+
+        running_ = false;
+    }
+    condition_.notify_all();
+
+    if (thread_.joinable())
+        thread_.join();
+
+    /* Release those still waiting. */
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& promise : promises_)
+        promise.set_value(FrameHandle());
+    promises_.clear();
+}
+
+
+bool CameraEventLoop::is_running() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    return running_;
+}
+
+
+std::uint64_t CameraEventLoop::number_failures() const
+{
+    return failures_;
+}
+
+
+void CameraEventLoop::run()
+{
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+
+            condition_.wait(lock, [this]{ return !running_ || (frame_received_ && has_demand()); });
+            if (!running_)
+                return;
+
+            frame_received_ = false;
+        }
+
+        /* The newest frame is already available, hence the request does not block. */
+        bool valid_frame = false;
+        RobotsIO::Camera::Camera::Frame frame;
+        try
+        {
+            std::tie(valid_frame, frame) = camera_.frame(false, enable_depth_);
+        }
+        catch (const std::exception& exception)
+        {
+            report_failure("run", exception.what());
+        }
+        catch (...)
+        {
+            report_failure("run", "unknown exception");
+        }
+
+        if (valid_frame)
+            dispatch(std::make_shared<const RobotsIO::Camera::Camera::Frame>(std::move(frame)));
+    }
+}
+
+
+void CameraEventLoop::run_offline()
+{
+    FrameHandle prefetched;
+
+    while (true)
+    {
+        /* Keep the next frame ready while the previous one is being processed. */
+        if (prefetched == nullptr)
+        {
+            bool valid_frame = false;
+            RobotsIO::Camera::Camera::Frame frame;
+            try
+            {
+                if (camera_.step_frame())
+                    std::tie(valid_frame, frame) = camera_.frame(true, enable_depth_);
+            }
+            catch (const std::exception& exception)
+            {
+                report_failure("run_offline", exception.what());
+            }
+            catch (...)
+            {
+                report_failure("run_offline", "unknown exception");
+            }
+
+            if (!valid_frame)
+            {
+                /* End of the offline data, or data that cannot be played back. */
+                std::lock_guard<std::mutex> lock(mutex_);
+                running_ = false;
+                for (auto& promise : promises_)
+                    promise.set_value(FrameHandle());
+                promises_.clear();
+
+                return;
+            }
+
+            prefetched = std::make_shared<const RobotsIO::Camera::Camera::Frame>(std::move(frame));
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+
+            condition_.wait(lock, [this]{ return !running_ || has_demand(); });
+            if (!running_)
+                return;
+        }
+
+        dispatch(prefetched);
+        prefetched.reset();
+    }
+}
+
+
+bool CameraEventLoop::has_demand() const
+{
+    /* Requires the mutex to be locked. */
+    return !(callbacks_.empty() && promises_.empty());
+}
+
+
+void CameraEventLoop::dispatch(const FrameHandle& frame)
+{
+    std::vector<Callback> callbacks;
+    std::vector<std::promise<FrameHandle>> promises;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        for (const auto& callback : callbacks_)
+            callbacks.push_back(callback.second);
+        promises.swap(promises_);
+    }
+
+    /* Consumers share the same frame, without copies. */
+    for (auto& promise : promises)
+        promise.set_value(frame);
+
+    /* A callback throwing does not prevent the others from being invoked. */
+    for (const auto& callback : callbacks)
+    {
+        try
+        {
+            callback(frame);
+        }
+        catch (const std::exception& exception)
+        {
+            report_failure("dispatch", exception.what());
+        }
+        catch (...)
+        {
+            report_failure("dispatch", "unknown exception");
+        }
+    }
+}
+
+
+void CameraEventLoop::notify_frame_received()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        frame_received_ = true;
+    }
+    condition_.notify_all();
+}
+
+
+void CameraEventLoop::on_new_demand()
+{
+    /* Frames received while there was no demand are older than the request, hence they are not delivered. */
+    if (!has_demand())
+        frame_received_ = false;
+}
+
+
+void CameraEventLoop::report_failure(const std::string& method, const std::string& what)
+{
+    /* Exceptions cannot propagate to the caller, hence they are counted and only the first one is reported. */
+    if (failures_++ == 0)
+        std::cerr << log_name_ + "::" + method + ". Error: an exception was thrown (" << what << "), further failures are only counted." << std::endl;
+}
@@ -6,16 +6,20 @@
  */
 
 #include <RobotsIO/Camera/YarpCamera.h>
+#include <RobotsIO/Utils/YarpImageConversion.h>
 
 #include <iostream>
 
 #include <yarp/cv/Cv.h>
 #include <yarp/eigen/Eigen.h>
+#include <yarp/os/Stamp.h>
 
 using namespace Eigen;
 using namespace RobotsIO::Camera;
+using namespace RobotsIO::Utils;
 using namespace yarp::cv;
 using namespace yarp::eigen;
+using namespace yarp::os;
 using namespace yarp::sig;
 
 
@@ -28,7 +32,8 @@ YarpCamera::YarpCamera
     const double& fy,
     const double& cy,
     const std::string& port_prefix
-)
+) :
+    port_prefix_(port_prefix)
 {
     /* Check YARP network. */
     if (!yarp_.checkNetwork())
@@ -89,6 +94,12 @@ YarpCamera::YarpCamera
 
 YarpCamera::~YarpCamera()
 {
+    pose_stream_.reset();
+
+    /* Stop grabbing frames before closing the ports. */
+    depth_grabber_.reset();
+    rgb_grabber_.reset();
+
     /* Close ports. */
     port_rgb_.close();
 
@@ -98,34 +109,216 @@ YarpCamera::~YarpCamera()
 
 std::pair<bool, MatrixXf> YarpCamera::depth(const bool& blocking)
 {
-    ImageOf<PixelFloat>* image_in;
-    image_in = port_depth_.read(blocking);
+    /* Unless frames are grabbed, the image is converted straight into the output, without passing through the pool. */
+    MatrixXf depth;
+    const bool valid_depth = this->depth(blocking, depth);
+
+    return std::make_pair(valid_depth, std::move(depth));
+}
+
+
+bool YarpCamera::depth(const bool& blocking, MatrixXf& depth)
+{
+    /* Grabbed frames are copied, otherwise the image is converted straight into the output. */
+    if (depth_grabber_)
+    {
+        bool valid_depth = false;
+        std::shared_ptr<const MatrixXf> buffer;
+        std::tie(valid_depth, buffer) = depth_buffer(blocking);
+        if (!valid_depth)
+            return false;
 
+        depth = *buffer;
+
+        return true;
+    }
+
+    ImageOf<PixelFloat>* image_in = read_depth(blocking);
     if (image_in == nullptr)
-        return std::make_pair(false, MatrixXf());
+        return false;
+
+    yarp_image_to_depth(*image_in, depth);
+
+    return true;
+}
 
-    cv::Mat image = yarp::cv::toCvMat(*image_in);
-    Map<Eigen::Matrix<float, Dynamic, Dynamic, Eigen::RowMajor>> depth(image.ptr<float>(), image.rows, image.cols);
+
+std::pair<bool, std::shared_ptr<const MatrixXf>> YarpCamera::depth_buffer(const bool& blocking)
+{
+    if (depth_grabber_)
+    {
+        bool valid_frame = false;
+        YarpFrameGrabber<ImageOf<PixelFloat>, MatrixXf>::Frame frame;
+        std::tie(valid_frame, frame) = blocking ? depth_grabber_->wait_newer(depth_sequence_) : depth_grabber_->latest();
+        if (!valid_frame)
+            return std::make_pair(false, std::shared_ptr<const MatrixXf>());
+
+        depth_sequence_ = frame.sequence;
+        valid_depth_timestamp_ = frame.valid_timestamp;
+        if (valid_depth_timestamp_)
+            depth_timestamp_ = frame.timestamp;
+
+        return std::make_pair(true, frame.data);
+    }
+
+    ImageOf<PixelFloat>* image_in = read_depth(blocking);
+    if (image_in == nullptr)
+        return std::make_pair(false, std::shared_ptr<const MatrixXf>());
+
+    std::shared_ptr<MatrixXf> depth = depth_pool_.acquire();
+    yarp_image_to_depth(*image_in, *depth);
 
     return std::make_pair(true, depth);
 }
 
 
+bool YarpCamera::enable_frame_grabbing()
+{
+    if (is_offline())
+        return false;
+
+    if (!depth_grabber_)
+        depth_grabber_ = std::unique_ptr<YarpFrameGrabber<ImageOf<PixelFloat>, MatrixXf>>(new YarpFrameGrabber<ImageOf<PixelFloat>, MatrixXf>(port_depth_, yarp_image_to_depth));
+
+    if (!rgb_grabber_)
+        rgb_grabber_ = std::unique_ptr<YarpFrameGrabber<ImageOf<PixelRgb>, cv::Mat>>(new YarpFrameGrabber<ImageOf<PixelRgb>, cv::Mat>(port_rgb_, yarp_image_to_bgr, is_mat_shared));
+
+    return true;
+}
+
+
+bool YarpCamera::set_frame_listener(const std::function<void()>& listener)
+{
+    /* Removing the listener does not require, nor enable, frame grabbing. */
+    if (!listener)
+    {
+        if (rgb_grabber_)
+            rgb_grabber_->set_listener(nullptr);
+
+        return true;
+    }
+
+    if (!enable_frame_grabbing())
+        return false;
+
+    /* New frames are announced by the rgb stream. */
+    rgb_grabber_->set_listener(listener);
+
+    return true;
+}
+
+
+bool YarpCamera::enable_pose_stream(const std::size_t& history_size)
+{
+    if (is_offline())
+        return false;
+
+    pose_stream_ = std::unique_ptr<YarpPoseStream>(new YarpPoseStream("/" + port_prefix_ + "/pose:i", history_size));
+
+    return true;
+}
+
+
 std::pair<bool, Transform<double, 3, Affine>> YarpCamera::pose(const bool& blocking)
 {
-    return std::make_pair(true, Transform<double, 3, Affine>::Identity());
+    if (!pose_stream_)
+        return std::make_pair(true, Transform<double, 3, Affine>::Identity());
+
+    /* Poses are received in background, hence the request never blocks. */
+    if (valid_rgb_timestamp_)
+        return pose_stream_->pose_at(rgb_timestamp_);
+
+    return pose_stream_->latest_pose();
 }
 
 
 std::pair<bool, cv::Mat> YarpCamera::rgb(const bool& blocking)
 {
+    if (rgb_grabber_)
+    {
+        bool valid_frame = false;
+        YarpFrameGrabber<ImageOf<PixelRgb>, cv::Mat>::Frame frame;
+        std::tie(valid_frame, frame) = blocking ? rgb_grabber_->wait_newer(rgb_sequence_) : rgb_grabber_->latest();
+        if (!valid_frame)
+            return std::make_pair(false, cv::Mat());
+
+        rgb_sequence_ = frame.sequence;
+        valid_rgb_timestamp_ = frame.valid_timestamp;
+        if (valid_rgb_timestamp_)
+            rgb_timestamp_ = frame.timestamp;
+
+        /* The header shares the pooled buffer, which is not recycled while referenced. */
+        return std::make_pair(true, *frame.data);
+    }
+
     ImageOf<PixelRgb>* image_in;
     image_in = port_rgb_.read(blocking);
 
     if (image_in == nullptr)
         return std::make_pair(false, cv::Mat());
 
-    cv::Mat image = yarp::cv::toCvMat(*image_in);
+    Stamp stamp;
+    valid_rgb_timestamp_ = port_rgb_.getEnvelope(stamp) && stamp.isValid();
+    if (valid_rgb_timestamp_)
+        rgb_timestamp_ = stamp.getTime();
+
+    std::shared_ptr<cv::Mat> image = rgb_pool_.acquire();
+    yarp_image_to_bgr(*image_in, *image);
+
+    return std::make_pair(true, *image);
+}
+
+
+std::pair<bool, Camera::Frame> YarpCamera::frame(const bool& blocking, const bool& enable_depth)
+{
+    bool valid_frame = false;
+    Frame frame;
+    std::tie(valid_frame, frame) = Camera::frame(blocking, enable_depth);
+
+    if (!valid_frame || is_offline())
+        return std::make_pair(valid_frame, frame);
+
+    frame.valid_rgb_timestamp = valid_rgb_timestamp_;
+    frame.rgb_timestamp = rgb_timestamp_;
+
+    if (enable_depth)
+    {
+        frame.valid_depth_timestamp = valid_depth_timestamp_;
+        frame.depth_timestamp = depth_timestamp_;
+    }
+
+    /* Poses from the stream are interpolated at the timestamp of the image. */
+    if (pose_stream_)
+    {
+        frame.valid_pose_timestamp = valid_rgb_timestamp_;
+        frame.pose_timestamp = rgb_timestamp_;
+    }
+
+    return std::make_pair(true, frame);
+}
+
+
+std::pair<bool, double> YarpCamera::rgb_timestamp() const
+{
+    if (is_offline())
+        return std::make_pair(false, 0.0);
+
+    return std::make_pair(valid_rgb_timestamp_, rgb_timestamp_);
+}
+
+
+ImageOf<PixelFloat>* YarpCamera::read_depth(const bool& blocking)
+{
+    ImageOf<PixelFloat>* image_in;
+    image_in = port_depth_.read(blocking);
+
+    if (image_in == nullptr)
+        return nullptr;
+
+    Stamp stamp;
+    valid_depth_timestamp_ = port_depth_.getEnvelope(stamp) && stamp.isValid();
+    if (valid_depth_timestamp_)
+        depth_timestamp_ = stamp.getTime();
 
-    return std::make_pair(true, image);
+    return image_in;
 }
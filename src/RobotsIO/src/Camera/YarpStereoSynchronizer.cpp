@@ -0,0 +1,217 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#include <RobotsIO/Camera/YarpStereoSynchronizer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <yarp/os/Stamp.h>
+#include <yarp/os/Time.h>
+
+using namespace RobotsIO::Camera;
+using namespace RobotsIO::Utils;
+using namespace yarp::os;
+using namespace yarp::sig;
+
+
+YarpStereoSynchronizer::YarpStereoSynchronizer
+(
+    const std::string& port_prefix,
+    const double& tolerance,
+    const std::size_t& buffer_size
+) :
+    tolerance_(tolerance),
+    left_(*this, buffer_size),
+    right_(*this, buffer_size)
+{
+    /* Check YARP network. */
+    if (!yarp_.checkNetwork())
+    {
+        throw(std::runtime_error(log_name_ + "::ctor. Error: YARP network is not available."));
+    }
+
+    if (buffer_size == 0)
+    {
+        throw(std::runtime_error(log_name_ + "::ctor. Error: the size of the buffers should be positive."));
+    }
+
+    /* Open left input port. */
+    if (!(left_.port.open("/" + port_prefix + "/left/rgbImage:i")))
+    {
+        std::string err = log_name_ + "::ctor. Error: cannot open left rgb input port.";
+        throw(std::runtime_error(err));
+    }
+
+    /* Open right input port. */
+    if (!(right_.port.open("/" + port_prefix + "/right/rgbImage:i")))
+    {
+        std::string err = log_name_ + "::ctor. Error: cannot open right rgb input port.";
+        throw(std::runtime_error(err));
+    }
+
+    /* Images are stored in the rings as soon as they are received. */
+    left_.port.useCallback(left_);
+    right_.port.useCallback(right_);
+}
+
+
+YarpStereoSynchronizer::~YarpStereoSynchronizer()
+{
+    /* Close ports. */
+    left_.port.close();
+
+    right_.port.close();
+}
+
+
+std::pair<bool, YarpStereoSynchronizer::StereoPair> YarpStereoSynchronizer::pair(const bool& blocking)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    std::size_t index_left;
+    std::size_t index_right;
+    while (!find_pair(index_left, index_right))
+    {
+        if (!blocking)
+            return std::make_pair(false, StereoPair());
+
+        image_received_.wait(lock);
+    }
+
+    StampedImage& left = left_.at(index_left);
+    StampedImage& right = right_.at(index_right);
+
+    /* Convert the images out of the rings, as these might be overwritten by the incoming ones. */
+    std::shared_ptr<cv::Mat> left_output = left_pool_.acquire();
+    std::shared_ptr<cv::Mat> right_output = right_pool_.acquire();
+    yarp_image_to_bgr(left.image, *left_output);
+    yarp_image_to_bgr(right.image, *right_output);
+
+    StereoPair pair;
+    /* The headers share the pooled buffers, which are not recycled while referenced. */
+    pair.left = *left_output;
+    pair.right = *right_output;
+    pair.left_timestamp = left.timestamp;
+    pair.right_timestamp = right.timestamp;
+
+    /* Update statistics. */
+    const double latency = Time::now() - std::max(left.arrival_time, right.arrival_time);
+    statistics_.pairs++;
+    statistics_.last_latency = latency;
+    statistics_.mean_latency += (latency - statistics_.mean_latency) / statistics_.pairs;
+    statistics_.last_skew = std::abs(left.timestamp - right.timestamp);
+
+    /* Images older than those delivered cannot be paired anymore. */
+    left_.dropped += index_left;
+    right_.dropped += index_right;
+    left_.pop_front(index_left + 1);
+    right_.pop_front(index_right + 1);
+
+    lock.unlock();
+
+    return std::make_pair(true, pair);
+}
+
+
+YarpStereoSynchronizer::Statistics YarpStereoSynchronizer::statistics() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Statistics statistics = statistics_;
+    statistics.dropped_left = left_.dropped;
+    statistics.dropped_right = right_.dropped;
+
+    return statistics;
+}
+
+
+bool YarpStereoSynchronizer::find_pair(std::size_t& index_left, std::size_t& index_right)
+{
+    /* Search, starting from the most recent left image, the first one having a right counterpart within the tolerance. */
+    for (std::size_t i = left_.size(); i-- > 0;)
+    {
+        const double timestamp_left = left_.at(i).timestamp;
+
+        double best_skew = std::numeric_limits<double>::infinity();
+        for (std::size_t j = 0; j < right_.size(); j++)
+        {
+            const double skew = std::abs(right_.at(j).timestamp - timestamp_left);
+            if (skew < best_skew)
+            {
+                best_skew = skew;
+                index_right = j;
+            }
+        }
+
+        if (best_skew <= tolerance_)
+        {
+            index_left = i;
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+YarpStereoSynchronizer::ImageRing::ImageRing(YarpStereoSynchronizer& synchronizer, const std::size_t& size) :
+    synchronizer_(synchronizer),
+    slots_(size)
+{}
+
+
+void YarpStereoSynchronizer::ImageRing::onRead(ImageOf<PixelRgb>& image)
+{
+    const double arrival_time = Time::now();
+
+    Stamp stamp;
+    const double timestamp = (port.getEnvelope(stamp) && stamp.isValid()) ? stamp.getTime() : arrival_time;
+
+    {
+        std::lock_guard<std::mutex> lock(synchronizer_.mutex_);
+
+        /* Overwrite the oldest image if the ring is full. */
+        if (count_ == slots_.size())
+        {
+            pop_front(1);
+            dropped++;
+        }
+
+        StampedImage& slot = slots_[(head_ + count_) % slots_.size()];
+        slot.image.copy(image);
+        slot.timestamp = timestamp;
+        slot.arrival_time = arrival_time;
+        count_++;
+    }
+
+    synchronizer_.image_received_.notify_all();
+}
+
+
+YarpStereoSynchronizer::StampedImage& YarpStereoSynchronizer::ImageRing::at(const std::size_t& index)
+{
+    /* Index 0 is the oldest image. */
+    return slots_[(head_ + index) % slots_.size()];
+}
+
+
+void YarpStereoSynchronizer::ImageRing::pop_front(const std::size_t& number)
+{
+    const std::size_t popped = std::min(number, count_);
+
+    head_ = (head_ + popped) % slots_.size();
+    count_ -= popped;
+}
+
+
+std::size_t YarpStereoSynchronizer::ImageRing::size() const
+{
+    return count_;
+}
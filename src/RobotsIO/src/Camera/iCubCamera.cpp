@@ -5,22 +5,28 @@
  * GPL-2+ license. See the accompanying LICENSE file for details.
  */
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #include <RobotsIO/Camera/iCubCamera.h>
+#include <RobotsIO/Utils/YarpImageConversion.h>
 
+#include <algorithm>
+#include <cstdio>
 #include <iostream>
 
-#include <unsupported/Eigen/MatrixFunctions>
-
 #include <yarp/cv/Cv.h>
 #include <yarp/eigen/Eigen.h>
 #include <yarp/os/LogStream.h>
 #include <yarp/os/Property.h>
 #include <yarp/os/ResourceFinder.h>
+#include <yarp/os/Stamp.h>
 #include <yarp/sig/Image.h>
 
 using namespace Eigen;
 using namespace RobotsIO::Camera;
-using namespace iCub::iKin;
+using namespace RobotsIO::Utils;
 using namespace yarp::cv;
 using namespace yarp::eigen;
 using namespace yarp::os;
@@ -136,18 +142,8 @@ iCubCamera::iCubCamera
         }
 
         /* Configure forward kinematics. */
-        left_eye_kinematics_ = iCubEye("left_v2");
-        right_eye_kinematics_ = iCubEye("right_v2");
-
-        left_eye_kinematics_.setAllConstraints(false);
-        right_eye_kinematics_.setAllConstraints(false);
-
-        left_eye_kinematics_.releaseLink(0);
-        left_eye_kinematics_.releaseLink(1);
-        left_eye_kinematics_.releaseLink(2);
-        right_eye_kinematics_.releaseLink(0);
-        right_eye_kinematics_.releaseLink(1);
-        right_eye_kinematics_.releaseLink(2);
+        left_eye_kinematics_ = std::unique_ptr<iCubEyeKinematics>(new iCubEyeKinematics("left_v2"));
+        right_eye_kinematics_ = std::unique_ptr<iCubEyeKinematics>(new iCubEyeKinematics("right_v2"));
     }
 
     /* Configure head.
@@ -229,6 +225,13 @@ iCubCamera::iCubCamera
 
 iCubCamera::~iCubCamera()
 {
+    /* Stop polling the encoders before closing the drivers. */
+    encoders_poller_.reset();
+
+    /* Stop grabbing frames before closing the ports. */
+    depth_grabber_.reset();
+    rgb_grabber_.reset();
+
     /* Close driver. */
     if (use_driver_gaze_)
       driver_gaze_.close();
@@ -269,24 +272,110 @@ bool iCubCamera::stop_motion()
 
 
 std::pair<bool, MatrixXf> iCubCamera::depth(const bool& blocking)
+{
+    /* Unless frames are grabbed, the image is converted straight into the output, without passing through the pool. */
+    MatrixXf depth;
+    const bool valid_depth = this->depth(blocking, depth);
+
+    return std::make_pair(valid_depth, std::move(depth));
+}
+
+
+bool iCubCamera::depth(const bool& blocking, MatrixXf& depth)
 {
     if (is_offline())
-        return Camera::depth_offline();
+    {
+        return Camera::depth_offline(depth);
+    }
 
-    ImageOf<PixelFloat>* image_in;
-    image_in = port_depth_.read(blocking);
+    /* Grabbed frames are copied, otherwise the image is converted straight into the output. */
+    if (depth_grabber_)
+    {
+        bool valid_depth = false;
+        std::shared_ptr<const MatrixXf> buffer;
+        std::tie(valid_depth, buffer) = depth_buffer(blocking);
+        if (!valid_depth)
+            return false;
+
+        depth = *buffer;
+
+        return true;
+    }
+
+    ImageOf<PixelFloat>* image_in = read_depth(blocking);
+    if (image_in == nullptr)
+        return false;
+
+    yarp_image_to_depth(*image_in, depth);
+
+    return true;
+}
+
+
+std::pair<bool, std::shared_ptr<const MatrixXf>> iCubCamera::depth_buffer(const bool& blocking)
+{
+    if (is_offline())
+    {
+        std::shared_ptr<MatrixXf> depth = depth_pool_.acquire();
+        const bool valid_depth = Camera::depth_offline(*depth);
+
+        return std::make_pair(valid_depth, depth);
+    }
+
+    if (depth_grabber_)
+    {
+        bool valid_frame = false;
+        YarpFrameGrabber<ImageOf<PixelFloat>, MatrixXf>::Frame frame;
+        std::tie(valid_frame, frame) = blocking ? depth_grabber_->wait_newer(depth_sequence_) : depth_grabber_->latest();
+        if (!valid_frame)
+            return std::make_pair(false, std::shared_ptr<const MatrixXf>());
+
+        depth_sequence_ = frame.sequence;
+        valid_depth_timestamp_ = frame.valid_timestamp;
+        if (valid_depth_timestamp_)
+            depth_timestamp_ = frame.timestamp;
+
+        return std::make_pair(true, frame.data);
+    }
 
+    ImageOf<PixelFloat>* image_in = read_depth(blocking);
     if (image_in == nullptr)
-        return std::make_pair(false, MatrixXf());
+        return std::make_pair(false, std::shared_ptr<const MatrixXf>());
 
-    cv::Mat image = yarp::cv::toCvMat(*image_in);
-    Map<Eigen::Matrix<float, Dynamic, Dynamic, Eigen::RowMajor>> depth(image.ptr<float>(), image.rows, image.cols);
+    std::shared_ptr<MatrixXf> depth = depth_pool_.acquire();
+    yarp_image_to_depth(*image_in, *depth);
 
     return std::make_pair(true, depth);
 }
 
 
 std::pair<bool, Transform<double, 3, Affine>> iCubCamera::pose(const bool& blocking)
+{
+    /* Use the offline poses, if evaluated. */
+    if (is_offline() && (frame_index_ >= 0) && (frame_index_ < offline_poses_calibrated_.cols()))
+    {
+        VectorXd data = offline_poses_calibrated_.col(frame_index_);
+
+        Transform<double, 3, Affine> pose;
+        pose = Translation<double, 3>(data.head<3>());
+        pose.rotate(AngleAxisd(data(6), data.segment<3>(3)));
+
+        return std::make_pair(true, pose);
+    }
+
+    /* The same snapshot feeds both the kinematics and the calibration model. */
+    EncodersSnapshot snapshot;
+    if (requires_encoders())
+    {
+        bool valid_snapshot = false;
+        std::tie(valid_snapshot, snapshot) = acquire_encoders_snapshot(pose_snapshot_consumed_);
+    }
+
+    return pose_from_encoders(snapshot);
+}
+
+
+std::pair<bool, Transform<double, 3, Affine>> iCubCamera::pose_from_encoders(const EncodersSnapshot& snapshot)
 {
     bool valid_pose = false;
     Transform<double, 3, Affine> pose;
@@ -294,7 +383,7 @@ std::pair<bool, Transform<double, 3, Affine>> iCubCamera::pose(const bool& block
     if (is_offline())
         std::tie(valid_pose, pose) = Camera::pose_offline();
     else
-        std::tie(valid_pose, pose) = laterality_pose(laterality_, blocking);
+        std::tie(valid_pose, pose) = laterality_pose(laterality_, snapshot);
 
     if (!valid_pose)
         return std::make_pair(false, Transform<double, 3, Affine>());
@@ -302,34 +391,151 @@ std::pair<bool, Transform<double, 3, Affine>> iCubCamera::pose(const bool& block
     /* If calibration was loaded and eye encoders are available, correct pose of right eye. */
     if ((laterality() == "right") && use_calibration_)
     {
-        bool valid_encoders_input = false;
-        if ((ihead_ != nullptr) || (load_encoders_data_))
+        if (snapshot.valid_head)
         {
-            /* Set input. */
-            Eigen::VectorXd head_encoders(6);
-            std::tie(valid_encoders_input, head_encoders) = auxiliary_data(true);
+            /* Get prediction. */
+            Eigen::VectorXd prediction = calibration_prediction(snapshot.head.tail<3>() * M_PI / 180.0);
+
+            /* Convert to SE3. */
+            Eigen::Transform<double, 3, Eigen::Affine> output = exp_map(prediction);
+
+            pose = pose * output;
+        }
+        else
+            std::cout << log_name_ + "::pose. Warning: calibration requested, however eyes encoders cannot be retrieved." << std::endl;
+    }
 
-            /* Corrrect pose of the righe eye. */
-            if (valid_encoders_input)
+    return std::make_pair(true, pose);
+}
+
+
+std::pair<bool, CalibrationLookupGrid::Report> iCubCamera::enable_calibration_lookup
+(
+    const Eigen::Vector3d& lower_bounds,
+    const Eigen::Vector3d& upper_bounds,
+    const Eigen::Vector3i& resolution,
+    const double& translation_error_bound,
+    const double& rotation_error_bound
+)
+{
+    if (!((laterality_ == "right") && use_calibration_))
+        return std::make_pair(false, CalibrationLookupGrid::Report());
+
+    auto model = [this](const Eigen::Vector3d& input) -> CalibrationLookupGrid::Vector6d
+    {
+        return calibration_model_prediction(input);
+    };
+
+    /* The model is queried with the eyes encoders expressed in radians. */
+    calibration_grid_.reset();
+    std::unique_ptr<CalibrationLookupGrid> grid(new CalibrationLookupGrid(model, lower_bounds * M_PI / 180.0, upper_bounds * M_PI / 180.0, resolution, translation_error_bound, rotation_error_bound));
+
+    const bool valid_grid = grid->is_within_error_bounds();
+    const CalibrationLookupGrid::Report report = grid->report();
+
+    if (valid_grid)
+        calibration_grid_ = std::move(grid);
+    else
+        std::cout << log_name_ + "::enable_calibration_lookup. Warning: the grid does not satisfy the error bounds, the calibration model will be used directly." << std::endl;
+
+    return std::make_pair(valid_grid, report);
+}
+
+
+bool iCubCamera::evaluate_offline_poses(const bool& use_persistence)
+{
+    if (!is_offline())
+        return false;
+
+    const std::string file_name = data_path_ + "poses_" + laterality_ + ".double";
+    if (use_persistence && load_offline_poses(file_name))
+        return true;
+
+    const std::size_t number_of_frames = data_.cols();
+
+    /* Raw poses are stored in the offline data after the frame index. */
+    offline_poses_raw_ = data_.middleRows(1, 7);
+    offline_poses_calibrated_ = offline_poses_raw_;
+
+    const bool calibration = (laterality_ == "right") && use_calibration_;
+    if (calibration)
+    {
+        if (!load_encoders_data_)
+            std::cout << log_name_ + "::evaluate_offline_poses. Warning: calibration requested, however eyes encoders are not available." << std::endl;
+        else
+        {
+            /* The calibration model is used directly, since the lookup grid, if any, is not thread safe. */
+#pragma omp parallel for
+            for (std::size_t i = 0; i < number_of_frames; i++)
             {
-                yarp::sig::Vector input(3);
-                toEigen(input) = head_encoders.tail<3>() * M_PI / 180.0;
+                VectorXd data = data_.col(i);
 
-                /* Get prediction. */
-                yarp::sig::Vector prediction = calibration_.predict(input).getPrediction();
+                Transform<double, 3, Affine> pose;
+                pose = Translation<double, 3>(data.segment<3>(1));
+                pose.rotate(AngleAxisd(data(7), data.segment<3>(4)));
 
-                /* Convert to SE3. */
-                Eigen::Transform<double, 3, Eigen::Affine> output = exp_map(yarp::eigen::toEigen(prediction));
+                /* Eyes encoders are the last three auxiliary data. */
+                const Vector3d eyes = data.segment<3>(standard_data_offset_ + 3 + 3) * M_PI / 180.0;
+                pose = pose * exp_map(calibration_model_prediction(eyes));
 
-                pose = pose * output;
+                AngleAxisd angle_axis(pose.rotation());
+                offline_poses_calibrated_.col(i).head<3>() = pose.translation();
+                offline_poses_calibrated_.col(i).segment<3>(3) = angle_axis.axis();
+                offline_poses_calibrated_(6, i) = angle_axis.angle();
             }
         }
-
-        if (!valid_encoders_input)
-            std::cout << log_name_ + "::pose. Warning: calibration requested, however eyes encoders cannot be retrieved." << std::endl;
     }
 
-    return std::make_pair(true, pose);
+    if (use_persistence && !save_offline_poses(file_name))
+        std::cout << log_name_ + "::evaluate_offline_poses. Warning: cannot save poses to " + file_name << std::endl;
+
+    return true;
+}
+
+
+std::pair<bool, Eigen::MatrixXd> iCubCamera::offline_poses(const bool& calibrated) const
+{
+    const MatrixXd& poses = calibrated ? offline_poses_calibrated_ : offline_poses_raw_;
+
+    if (poses.size() == 0)
+        return std::make_pair(false, MatrixXd());
+
+    return std::make_pair(true, poses);
+}
+
+
+bool iCubCamera::enable_encoders_polling(const double& period, const std::size_t& history_size)
+{
+    if (is_offline() || (ihead_ == nullptr))
+        return false;
+
+    /* Torso encoders are available only if the gaze controller is not used. */
+    std::vector<yarp::dev::IEncodersTimed*> encoders;
+    if (itorso_ != nullptr)
+        encoders.push_back(itorso_);
+    encoders.push_back(ihead_);
+
+    encoders_poller_ = std::unique_ptr<RobotsIO::Utils::YarpEncodersPoller>
+    (
+        new RobotsIO::Utils::YarpEncodersPoller(encoders, period, history_size)
+    );
+
+    return encoders_poller_->start();
+}
+
+
+std::pair<bool, Transform<double, 3, Affine>> iCubCamera::pose_at(const double& timestamp)
+{
+    if (encoders_poller_ == nullptr)
+        return std::make_pair(false, Transform<double, 3, Affine>());
+
+    bool valid_snapshot = false;
+    EncodersSnapshot snapshot;
+    std::tie(valid_snapshot, snapshot) = polled_encoders_snapshot(true, timestamp);
+    if (!valid_snapshot)
+        return std::make_pair(false, Transform<double, 3, Affine>());
+
+    return pose_from_encoders(snapshot);
 }
 
 
@@ -338,15 +544,108 @@ std::pair<bool, cv::Mat> iCubCamera::rgb(const bool& blocking)
     if (is_offline())
         return Camera::rgb_offline();
 
+    if (rgb_grabber_)
+    {
+        bool valid_frame = false;
+        YarpFrameGrabber<ImageOf<PixelRgb>, cv::Mat>::Frame frame;
+        std::tie(valid_frame, frame) = blocking ? rgb_grabber_->wait_newer(rgb_sequence_) : rgb_grabber_->latest();
+        if (!valid_frame)
+            return std::make_pair(false, cv::Mat());
+
+        rgb_sequence_ = frame.sequence;
+        valid_rgb_timestamp_ = frame.valid_timestamp;
+        if (valid_rgb_timestamp_)
+            rgb_timestamp_ = frame.timestamp;
+
+        /* The header shares the pooled buffer, which is not recycled while referenced. */
+        return std::make_pair(true, *frame.data);
+    }
+
     ImageOf<PixelRgb>* image_in;
     image_in = port_rgb_.read(blocking);
 
     if (image_in == nullptr)
         return std::make_pair(false, cv::Mat());
 
-    cv::Mat image = yarp::cv::toCvMat(*image_in);
+    Stamp stamp;
+    valid_rgb_timestamp_ = port_rgb_.getEnvelope(stamp) && stamp.isValid();
+    if (valid_rgb_timestamp_)
+        rgb_timestamp_ = stamp.getTime();
+
+    std::shared_ptr<cv::Mat> image = rgb_pool_.acquire();
+    yarp_image_to_bgr(*image_in, *image);
+
+    return std::make_pair(true, *image);
+}
+
+
+std::pair<bool, Camera::Frame> iCubCamera::frame(const bool& blocking, const bool& enable_depth)
+{
+    bool valid_frame = false;
+    Frame frame;
+    std::tie(valid_frame, frame) = Camera::frame(blocking, enable_depth);
+
+    if (!valid_frame || is_offline())
+        return std::make_pair(valid_frame, frame);
+
+    frame.valid_rgb_timestamp = valid_rgb_timestamp_;
+    frame.rgb_timestamp = rgb_timestamp_;
+
+    if (enable_depth)
+    {
+        frame.valid_depth_timestamp = valid_depth_timestamp_;
+        frame.depth_timestamp = depth_timestamp_;
+    }
+
+    /* The pose is evaluated from the current encoders snapshot, if required. */
+    std::tie(frame.valid_pose_timestamp, frame.pose_timestamp) = encoders_snapshot_timestamp();
+
+    return std::make_pair(true, frame);
+}
+
+
+bool iCubCamera::enable_frame_grabbing()
+{
+    if (is_offline())
+        return false;
+
+    if (!depth_grabber_)
+        depth_grabber_ = std::unique_ptr<YarpFrameGrabber<ImageOf<PixelFloat>, MatrixXf>>(new YarpFrameGrabber<ImageOf<PixelFloat>, MatrixXf>(port_depth_, yarp_image_to_depth));
+
+    if (!rgb_grabber_)
+        rgb_grabber_ = std::unique_ptr<YarpFrameGrabber<ImageOf<PixelRgb>, cv::Mat>>(new YarpFrameGrabber<ImageOf<PixelRgb>, cv::Mat>(port_rgb_, yarp_image_to_bgr, is_mat_shared));
+
+    return true;
+}
+
+
+bool iCubCamera::set_frame_listener(const std::function<void()>& listener)
+{
+    /* Removing the listener does not require, nor enable, frame grabbing. */
+    if (!listener)
+    {
+        if (rgb_grabber_)
+            rgb_grabber_->set_listener(nullptr);
+
+        return true;
+    }
+
+    if (!enable_frame_grabbing())
+        return false;
+
+    /* New frames are announced by the rgb stream. */
+    rgb_grabber_->set_listener(listener);
+
+    return true;
+}
+
+
+std::pair<bool, double> iCubCamera::rgb_timestamp() const
+{
+    if (is_offline())
+        return std::make_pair(false, 0.0);
 
-    return std::make_pair(true, image);
+    return std::make_pair(valid_rgb_timestamp_, rgb_timestamp_);
 }
 
 
@@ -359,18 +658,15 @@ std::pair<bool, Eigen::VectorXd> iCubCamera::auxiliary_data(const bool& blocking
     if (use_driver_gaze_)
         return std::make_pair(false, VectorXd());
 
-    yarp::sig::Vector torso_encoders_(3);
-    yarp::sig::Vector head_encoders_(6);
-
-    if (!itorso_->getEncoders(torso_encoders_.data()))
-        return std::make_pair(false, VectorXd());
-
-    if (!ihead_->getEncoders(head_encoders_.data()))
+    bool valid_snapshot = false;
+    EncodersSnapshot snapshot;
+    std::tie(valid_snapshot, snapshot) = acquire_encoders_snapshot(auxiliary_snapshot_consumed_);
+    if (!valid_snapshot || !snapshot.valid_torso || !snapshot.valid_head)
         return std::make_pair(false, VectorXd());
 
     VectorXd encoders(9);
-    encoders.head<3>() = toEigen(torso_encoders_);
-    encoders.tail<6>() = toEigen(head_encoders_);
+    encoders.head<3>() = snapshot.torso;
+    encoders.tail<6>() = snapshot.head;
 
     return std::make_pair(true, encoders);
 }
@@ -392,22 +688,37 @@ std::string iCubCamera::laterality()
 }
 
 
-std::pair<bool, Eigen::Transform<double, 3, Eigen::Affine>> iCubCamera::laterality_pose(const std::string& laterality, const bool& blocking)
+std::pair<bool, Eigen::Transform<double, 3, Eigen::Affine>> iCubCamera::laterality_pose(const std::string& laterality, const EncodersSnapshot& snapshot)
 {
-    Transform<double, 3, Affine> pose;
+    if ((laterality != "left") && (laterality != "right"))
+        return std::make_pair(false, Transform<double, 3, Affine>());
+
+    if (use_driver_gaze_)
+    {
+        Transform<double, 3, Affine> pose;
 
-    yarp::sig::Vector position_yarp;
-    yarp::sig::Vector orientation_yarp;
+        yarp::sig::Vector position_yarp;
+        yarp::sig::Vector orientation_yarp;
 
-    bool ok = getLateralityEyePose(laterality, position_yarp, orientation_yarp);
+        bool ok = getLateralityEyePose(laterality, position_yarp, orientation_yarp);
 
-    if (!ok)
-        return std::make_pair(false, Transform<double, 3, Affine>());
+        if (!ok)
+            return std::make_pair(false, Transform<double, 3, Affine>());
 
-    pose = Translation<double, 3>(toEigen(position_yarp));
-    pose.rotate(AngleAxisd(orientation_yarp(3), toEigen(orientation_yarp).head<3>()));
+        pose = Translation<double, 3>(toEigen(position_yarp));
+        pose.rotate(AngleAxisd(orientation_yarp(3), toEigen(orientation_yarp).head<3>()));
 
-    return std::make_pair(true, pose);
+        return std::make_pair(true, pose);
+    }
+
+    /* Fallback to forward kinematics from encoders. */
+    if (!snapshot.valid_torso || !snapshot.valid_head)
+        return std::make_pair(false, Transform<double, 3, Affine>());
+
+    if (laterality == "left")
+        return std::make_pair(true, left_eye_kinematics_->pose_from_encoders(snapshot.torso, snapshot.head));
+    else
+        return std::make_pair(true, right_eye_kinematics_->pose_from_encoders(snapshot.torso, snapshot.head));
 }
 
 
@@ -417,59 +728,160 @@ void iCubCamera::set_laterality(const std::string& laterality)
 }
 
 
-bool iCubCamera::getLateralityEyePose(const std::string& laterality, yarp::sig::Vector& position, yarp::sig::Vector& orientation)
+std::pair<bool, iCubCamera::EncodersSnapshot> iCubCamera::acquire_encoders_snapshot(bool& consumed)
 {
-    if ((laterality != "left") && (laterality != "right"))
-            return false;
-
-    if (use_driver_gaze_)
+    /* In offline mode the data is already in memory, hence the snapshot is always refreshed in order to follow the frame index. */
+    if (consumed || !valid_snapshot_ || is_offline())
     {
-        if (laterality == "left")
-            return gaze_control_->getLeftEyePose(position, orientation);
-        else
-            return gaze_control_->getRightEyePose(position, orientation);
+        /* Polled encoders are aligned with the last image. */
+        if (!refresh_encoders_snapshot(valid_rgb_timestamp_, rgb_timestamp_))
+            return std::make_pair(false, EncodersSnapshot());
     }
+
+    consumed = true;
+
+    return std::make_pair(true, snapshot_);
+}
+
+
+std::pair<bool, iCubCamera::EncodersSnapshot> iCubCamera::acquire_encoders_snapshot_at(const double& timestamp, bool& consumed)
+{
+    if (!refresh_encoders_snapshot(true, timestamp))
+        return std::make_pair(false, EncodersSnapshot());
+
+    consumed = true;
+
+    return std::make_pair(true, snapshot_);
+}
+
+
+std::pair<bool, double> iCubCamera::encoders_snapshot_timestamp() const
+{
+    if (!requires_encoders() || !valid_snapshot_ || !snapshot_.valid_timestamp)
+        return std::make_pair(false, 0.0);
+
+    return std::make_pair(true, snapshot_.timestamp);
+}
+
+
+bool iCubCamera::getLateralityEyePose(const std::string& laterality, yarp::sig::Vector& position, yarp::sig::Vector& orientation)
+{
+    if (laterality == "left")
+        return gaze_control_->getLeftEyePose(position, orientation);
     else
+        return gaze_control_->getRightEyePose(position, orientation);
+}
+
+
+bool iCubCamera::refresh_encoders_snapshot(const bool& use_timestamp, const double& timestamp)
+{
+    bool valid_snapshot = false;
+    EncodersSnapshot snapshot;
+    std::tie(valid_snapshot, snapshot) = read_encoders_snapshot(use_timestamp, timestamp);
+    if (!valid_snapshot)
+        return false;
+
+    /* All the consumers are now allowed to use the new snapshot. */
+    snapshot_ = snapshot;
+    valid_snapshot_ = true;
+    pose_snapshot_consumed_ = false;
+    auxiliary_snapshot_consumed_ = false;
+
+    return true;
+}
+
+
+std::pair<bool, iCubCamera::EncodersSnapshot> iCubCamera::read_encoders_snapshot(const bool& use_timestamp, const double& timestamp)
+{
+    EncodersSnapshot snapshot;
+
+    if (is_offline())
     {
-        yarp::sig::Vector torso_encoders_(3);
-        yarp::sig::Vector head_encoders_(6);
+        bool valid_data = false;
+        VectorXd data;
+        std::tie(valid_data, data) = Camera::auxiliary_data_offline();
+        if (!valid_data)
+            return std::make_pair(false, EncodersSnapshot());
+
+        snapshot.torso = data.head<3>();
+        snapshot.valid_torso = true;
+        snapshot.head = data.tail<6>();
+        snapshot.valid_head = true;
+
+        return std::make_pair(true, snapshot);
+    }
 
-        if (!itorso_->getEncoders(torso_encoders_.data()))
-            return false;
+    /* Use the polled encoders, if available, aligned with the requested timestamp. */
+    if (encoders_poller_ != nullptr)
+        return polled_encoders_snapshot(use_timestamp, timestamp);
 
-        if (!ihead_->getEncoders(head_encoders_.data()))
-            return false;
+    /* Head encoders are always available. */
+    if (ihead_ == nullptr)
+        return std::make_pair(false, EncodersSnapshot());
 
-        yarp::sig::Vector chain_joints(8);
-        chain_joints(0) = torso_encoders_(2);
-        chain_joints(1) = torso_encoders_(1);
-        chain_joints(2) = torso_encoders_(0);
-        chain_joints(3) = head_encoders_(0);
-        chain_joints(4) = head_encoders_(1);
-        chain_joints(5) = head_encoders_(2);
-        chain_joints(6) = head_encoders_(3);
+    /* Encoders are read straight into the snapshot. */
+    Eigen::Matrix<double, 6, 1, Eigen::DontAlign> head_timestamps;
+    if (!ihead_->getEncodersTimed(snapshot.head.data(), head_timestamps.data()))
+        return std::make_pair(false, EncodersSnapshot());
 
-        double version = head_encoders_(4);
-        double vergence = head_encoders_(5);
+    snapshot.valid_head = true;
+    snapshot.timestamp = head_timestamps.maxCoeff();
+    snapshot.valid_timestamp = true;
 
-        if (laterality == "left")
-            chain_joints(7) = version + vergence / 2.0;
-        else
-            chain_joints(7) = version - vergence / 2.0;
+    /* Torso encoders are available only if the gaze controller is not used. */
+    if (itorso_ != nullptr)
+    {
+        Eigen::Matrix<double, 3, 1, Eigen::DontAlign> torso_timestamps;
+        if (!itorso_->getEncodersTimed(snapshot.torso.data(), torso_timestamps.data()))
+            return std::make_pair(false, EncodersSnapshot());
 
-        yarp::sig::Vector pose;
-        if (laterality == "left")
-            pose = left_eye_kinematics_.EndEffPose(chain_joints * M_PI / 180.0);
-        else
-            pose = right_eye_kinematics_.EndEffPose(chain_joints * M_PI / 180.0);
+        snapshot.valid_torso = true;
+        snapshot.timestamp = std::max(snapshot.timestamp, torso_timestamps.maxCoeff());
+    }
 
-        position.resize(3);
-        orientation.resize(4);
-        position = pose.subVector(0, 2);
-        orientation = pose.subVector(3, 6);
+    return std::make_pair(true, snapshot);
+}
 
-        return true;
+
+std::pair<bool, iCubCamera::EncodersSnapshot> iCubCamera::polled_encoders_snapshot(const bool& use_timestamp, const double& timestamp)
+{
+    EncodersSnapshot snapshot;
+
+    /* The polled encoders are stored in a buffer reused across snapshots. */
+    bool valid_encoders = false;
+    VectorXd& encoders = polled_encoders_;
+    if (use_timestamp)
+    {
+        valid_encoders = encoders_poller_->encoders_at(timestamp, encoders);
+        snapshot.timestamp = timestamp;
+    }
+    else
+        valid_encoders = encoders_poller_->latest_encoders(snapshot.timestamp, encoders);
+
+    if (!valid_encoders)
+        return std::make_pair(false, EncodersSnapshot());
+    snapshot.valid_timestamp = true;
+
+    /* Polled encoders are the torso ones, if available, followed by the head ones. */
+    if (itorso_ != nullptr)
+    {
+        snapshot.torso = encoders.head<3>();
+        snapshot.valid_torso = true;
     }
+    snapshot.head = encoders.tail<6>();
+    snapshot.valid_head = true;
+
+    return std::make_pair(true, snapshot);
+}
+
+
+bool iCubCamera::requires_encoders() const
+{
+    /* Encoders are required by the forward kinematics and by the calibration model of the right eye. */
+    const bool kinematics = !is_offline() && !use_driver_gaze_;
+    const bool calibration = (laterality_ == "right") && use_calibration_;
+
+    return kinematics || calibration;
 }
 
 
@@ -484,17 +896,105 @@ Eigen::Transform<double, 3, Eigen::Affine> iCubCamera::exp_map(const Eigen::Vect
     log_R(1, 2) = -1.0 * se3(3);
     log_R(2, 0) = -1.0 * se3(4);
     log_R(2, 1) = se3(3);
+    const Eigen::Matrix3d log_R_2 = log_R * log_R;
 
-    double theta = se3.tail<3>().norm() + std::numeric_limits<double>::epsilon();
-    Eigen::Matrix3d V = Eigen::Matrix3d::Identity() + (1 - std::cos(theta)) / (theta * theta) * log_R + (theta - std::sin(theta)) / (std::pow(theta, 3)) * log_R * log_R;
+    /* Closed form of the exponential map (Rodrigues' formula), using Taylor expansions for small angles. */
+    const double theta = se3.tail<3>().norm();
+    const double theta_2 = theta * theta;
+    double a, b, c;
+    if (theta < 1e-4)
+    {
+        a = 1.0 - theta_2 / 6.0;
+        b = 0.5 - theta_2 / 24.0;
+        c = 1.0 / 6.0 - theta_2 / 120.0;
+    }
+    else
+    {
+        a = std::sin(theta) / theta;
+        b = (1.0 - std::cos(theta)) / theta_2;
+        c = (theta - std::sin(theta)) / (theta_2 * theta);
+    }
+
+    Eigen::Matrix3d R = Eigen::Matrix3d::Identity() + a * log_R + b * log_R_2;
+    Eigen::Matrix3d V = Eigen::Matrix3d::Identity() + b * log_R + c * log_R_2;
 
     SE3 = Eigen::Translation<double, 3>(V * se3.head<3>());
-    SE3.rotate(log_R.exp());
+    SE3.rotate(R);
 
     return SE3;
 }
 
 
+CalibrationLookupGrid::Vector6d iCubCamera::calibration_prediction(const Eigen::Vector3d& input)
+{
+    if (calibration_grid_)
+        return calibration_grid_->predict(input);
+
+    return calibration_model_prediction(input);
+}
+
+
+CalibrationLookupGrid::Vector6d iCubCamera::calibration_model_prediction(const Eigen::Vector3d& input)
+{
+    yarp::sig::Vector input_yarp(3);
+    toEigen(input_yarp) = input;
+
+    yarp::sig::Vector prediction = calibration_.predict(input_yarp).getPrediction();
+
+    return toEigen(prediction);
+}
+
+
+bool iCubCamera::load_offline_poses(const std::string& file_name)
+{
+    std::FILE* in;
+    if ((in = std::fopen(file_name.c_str(), "rb")) == nullptr)
+        return false;
+
+    /* Load size. */
+    std::size_t dims[2];
+    if ((std::fread(dims, sizeof(dims), 1, in) != 1) || (dims[0] != 7) || (dims[1] != std::size_t(data_.cols())))
+    {
+        std::fclose(in);
+        return false;
+    }
+
+    /* Load raw and calibrated poses. */
+    MatrixXd raw(dims[0], dims[1]);
+    MatrixXd calibrated(dims[0], dims[1]);
+    const bool valid_raw = std::fread(raw.data(), sizeof(double), raw.size(), in) == std::size_t(raw.size());
+    const bool valid_calibrated = std::fread(calibrated.data(), sizeof(double), calibrated.size(), in) == std::size_t(calibrated.size());
+
+    std::fclose(in);
+
+    if (!(valid_raw && valid_calibrated))
+        return false;
+
+    offline_poses_raw_.swap(raw);
+    offline_poses_calibrated_.swap(calibrated);
+
+    return true;
+}
+
+
+bool iCubCamera::save_offline_poses(const std::string& file_name) const
+{
+    std::FILE* out;
+    if ((out = std::fopen(file_name.c_str(), "wb")) == nullptr)
+        return false;
+
+    /* Save size, raw and calibrated poses. */
+    const std::size_t dims[2] = {std::size_t(offline_poses_raw_.rows()), std::size_t(offline_poses_raw_.cols())};
+    bool valid = std::fwrite(dims, sizeof(dims), 1, out) == 1;
+    valid &= std::fwrite(offline_poses_raw_.data(), sizeof(double), offline_poses_raw_.size(), out) == std::size_t(offline_poses_raw_.size());
+    valid &= std::fwrite(offline_poses_calibrated_.data(), sizeof(double), offline_poses_calibrated_.size(), out) == std::size_t(offline_poses_calibrated_.size());
+
+    std::fclose(out);
+
+    return valid;
+}
+
+
 bool iCubCamera::load_calibration_model(const std::string& model_path)
 {
     std::ifstream model_in;
@@ -512,3 +1012,20 @@ bool iCubCamera::load_calibration_model(const std::string& model_path)
 
     return true;
 }
+
+
+ImageOf<PixelFloat>* iCubCamera::read_depth(const bool& blocking)
+{
+    ImageOf<PixelFloat>* image_in;
+    image_in = port_depth_.read(blocking);
+
+    if (image_in == nullptr)
+        return nullptr;
+
+    Stamp stamp;
+    valid_depth_timestamp_ = port_depth_.getEnvelope(stamp) && stamp.isValid();
+    if (valid_depth_timestamp_)
+        depth_timestamp_ = stamp.getTime();
+
+    return image_in;
+}
@@ -72,74 +72,333 @@ std::pair<bool, Eigen::MatrixXd> iCubCameraDepth::deprojection_matrix() const
 
 std::pair<bool, Eigen::MatrixXf> iCubCameraDepth::depth(const bool& blocking)
 {
+    MatrixXf depth;
+    const bool valid_depth = this->depth(blocking, depth);
+
+    return std::make_pair(valid_depth, depth);
+}
+
+
+bool iCubCameraDepth::depth(const bool& blocking, MatrixXf& depth)
+{
+    bool valid_frame = false;
+    std::shared_ptr<const StereoFrame> frame;
+    std::tie(valid_frame, frame) = acquire_stereo_frame(blocking, depth_consumed_);
+    if (!valid_frame)
+        return false;
+
+    MatrixXf confidence;
+
+    return stereo_depth(*frame, false, depth, confidence);
+}
+
+
+std::tuple<bool, Eigen::MatrixXf, Eigen::MatrixXf> iCubCameraDepth::depth_with_confidence(const bool& blocking)
+{
+    MatrixXf depth;
+    MatrixXf confidence;
+    const bool valid_depth = depth_with_confidence(blocking, depth, confidence);
+
+    return std::make_tuple(valid_depth, depth, confidence);
+}
+
+
+bool iCubCameraDepth::depth_with_confidence(const bool& blocking, MatrixXf& depth, MatrixXf& confidence)
+{
+    bool valid_frame = false;
+    std::shared_ptr<const StereoFrame> frame;
+    std::tie(valid_frame, frame) = acquire_stereo_frame(blocking, confidence_consumed_);
+    if (!valid_frame)
+        return false;
+
+    return stereo_depth(*frame, true, depth, confidence);
+}
+
+
+std::pair<bool, Eigen::Transform<double, 3, Eigen::Affine>> iCubCameraDepth::pose(const bool& blocking)
+{
+    /* Since the depth is aligned with left camera, the left camera pose is returned here. */
+    bool valid_frame = false;
+    std::shared_ptr<const StereoFrame> frame;
+    std::tie(valid_frame, frame) = acquire_stereo_frame(blocking, pose_consumed_);
+    if (!valid_frame)
+        return std::make_pair(false, Transform<double, 3, Affine>());
+
+    return std::make_pair(true, frame->pose);
+}
+
+
+std::pair<bool, cv::Mat> iCubCameraDepth::rgb(const bool& blocking)
+{
+    /* Since the depth is aligned with left camera, the left image is returned here. */
+    bool valid_frame = false;
+    std::shared_ptr<const StereoFrame> frame;
+    std::tie(valid_frame, frame) = acquire_stereo_frame(blocking, rgb_consumed_);
+    if (!valid_frame)
+        return std::make_pair(false, cv::Mat());
+
+    return std::make_pair(true, frame->left);
+}
+
+
+std::pair<bool, Camera::Frame> iCubCameraDepth::frame(const bool& blocking, const bool& enable_depth)
+{
+    /* All the data, including the timestamps, come from a single stereo frame. */
+    bool valid_stereo_frame = false;
+    std::shared_ptr<const StereoFrame> stereo_frame;
+    std::tie(valid_stereo_frame, stereo_frame) = acquire_whole_stereo_frame(blocking);
+    if (!valid_stereo_frame)
+        return std::make_pair(false, Frame());
+
+    Frame frame;
+
+    /* The header shares the pooled image, which is not recycled while referenced. */
+    frame.rgb = stereo_frame->left;
+    frame.valid_rgb_timestamp = stereo_frame->valid_timestamp;
+    frame.rgb_timestamp = stereo_frame->timestamp;
+
+    if (enable_depth)
+    {
+        MatrixXf confidence;
+        if (!stereo_depth(*stereo_frame, false, frame.depth, confidence))
+            return std::make_pair(false, Frame());
+
+        frame.valid_depth_timestamp = stereo_frame->valid_timestamp;
+        frame.depth_timestamp = stereo_frame->timestamp;
+    }
+
+    frame.pose = stereo_frame->pose;
+    frame.valid_pose_timestamp = stereo_frame->valid_pose_timestamp;
+    frame.pose_timestamp = stereo_frame->pose_timestamp;
+
+    bool valid_auxiliary_data = false;
+    std::tie(valid_auxiliary_data, frame.auxiliary_data) = auxiliary_data(blocking);
+    if (!valid_auxiliary_data)
+        frame.auxiliary_data = VectorXd();
+
+    frame.sequence = is_offline() ? std::uint64_t(frame_index_) : ++frame_sequence_;
+
+    return std::make_pair(true, frame);
+}
+
+
+std::pair<bool, std::shared_ptr<const iCubCameraDepth::StereoFrame>> iCubCameraDepth::stereo_frame(const bool& blocking)
+{
+    return acquire_stereo_frame(blocking, stereo_frame_consumed_);
+}
+
+
+bool iCubCameraDepth::point_cloud_data
+(
+    const bool& blocking,
+    const bool& use_root_frame,
+    const bool& enable_colors,
+    const bool& use_confidence,
+    Transform<double, 3, Affine>& camera_pose
+)
+{
+    bool valid_frame = false;
+    std::shared_ptr<const StereoFrame> frame;
+    std::tie(valid_frame, frame) = acquire_whole_stereo_frame(blocking);
+    if (!valid_frame)
+        return false;
+
+    /* The header shares the pooled image, which is not recycled while referenced. */
+    if (enable_colors)
+        point_cloud_rgb_ = frame->left;
+
+    if (!stereo_depth(*frame, use_confidence, point_cloud_depth_, point_cloud_confidence_))
+        return false;
+
+    if (use_root_frame)
+        camera_pose = frame->pose;
+
+    return true;
+}
+
+
+bool iCubCameraDepth::step_frame()
+{
+    drop_stereo_frame();
+
+    return iCubCameraRelative::step_frame();
+}
+
+
+bool iCubCameraDepth::set_frame_index(const std::int32_t& index)
+{
+    drop_stereo_frame();
+
+    return iCubCameraRelative::set_frame_index(index);
+}
+
+
+std::pair<bool, std::shared_ptr<const iCubCameraDepth::StereoFrame>> iCubCameraDepth::acquire_stereo_frame(const bool& blocking, bool& consumed)
+{
+    if (consumed || (stereo_frame_ == nullptr))
+    {
+        bool valid_frame = false;
+        std::shared_ptr<const StereoFrame> frame;
+        std::tie(valid_frame, frame) = grab_stereo_frame(blocking);
+        if (!valid_frame)
+            return std::make_pair(false, nullptr);
+
+        /* All the accessors are now allowed to use the new frame. */
+        stereo_frame_ = frame;
+        rgb_consumed_ = false;
+        depth_consumed_ = false;
+        confidence_consumed_ = false;
+        pose_consumed_ = false;
+        stereo_frame_consumed_ = false;
+    }
+
+    consumed = true;
+
+    return std::make_pair(true, stereo_frame_);
+}
+
+
+std::pair<bool, std::shared_ptr<const iCubCameraDepth::StereoFrame>> iCubCameraDepth::acquire_whole_stereo_frame(const bool& blocking)
+{
+    bool valid_frame = false;
+    std::shared_ptr<const StereoFrame> frame;
+    std::tie(valid_frame, frame) = grab_stereo_frame(blocking);
+    if (!valid_frame)
+        return std::make_pair(false, nullptr);
+
+    /* The frame is left available to stereo_frame() only, such that the caller can retrieve the rest of it. */
+    stereo_frame_ = frame;
+    rgb_consumed_ = true;
+    depth_consumed_ = true;
+    confidence_consumed_ = true;
+    pose_consumed_ = true;
+    stereo_frame_consumed_ = false;
+
+    return std::make_pair(true, frame);
+}
+
+
+std::pair<bool, std::shared_ptr<const iCubCameraDepth::StereoFrame>> iCubCameraDepth::grab_stereo_frame(const bool& blocking)
+{
+    std::shared_ptr<StereoFrame> frame = stereo_frame_pool_.acquire();
+
+    /* Images of a recycled frame are released first, such that their buffers can be recycled by the cameras. */
+    frame->left.release();
+    frame->right.release();
+
     /* Get the images. */
     bool valid_rgb = false;
-    cv::Mat rgb_left;
-    cv::Mat rgb_right;
-    std::tie(valid_rgb, rgb_left) = get_relative_camera().rgb(blocking);
-    if (!valid_rgb)
-        return std::make_pair(false, MatrixXf());
-
-    valid_rgb = false;
-    std::tie(valid_rgb, rgb_right) = iCubCameraRelative::rgb(blocking);
-    if (!valid_rgb)
-        return std::make_pair(false, MatrixXf());
-
-    /* Get the extrinsic matrix. */
-    bool valid_pose = false;
-    Transform<double, 3, Affine> pose;
-    std::tie(valid_pose, pose) = iCubCameraRelative::pose(blocking);
-    if (!valid_pose)
-        return std::make_pair(false, MatrixXf());
-    /* As required by SGBM. */
-    pose = pose.inverse();
-
-    /* Set the extrinsic matrix in OpenCV format. */
-    MatrixXd translation = pose.translation();
-    cv::Mat R;
-    cv::Mat t;
-    cv::eigen2cv(translation, t);
-    cv::eigen2cv(pose.rotation(), R);
-
-    /* Perform rectification. */
-    cv::Mat R1;
-    cv::Mat R2;
-    cv::Mat P1;
-    cv::Mat P2;
-    cv::Mat Q;
-    cv::stereoRectify(intrinsic_left_, distortion_left_,
-                      intrinsic_right_, distortion_right_,
-                      rgb_left.size(),
-                      R, t,
-                      R1, R2, P1, P2, Q, -1);
-
-    cv::Mat mapl0;
-    cv::Mat mapl1;
-    cv::Mat mapr0;
-    cv::Mat mapr1;
-    cv::initUndistortRectifyMap(intrinsic_left_, distortion_left_, R1, P1, rgb_left.size(), CV_32FC1, mapl0, mapl1);
-    cv::initUndistortRectifyMap(intrinsic_right_, distortion_right_, R2, P2, rgb_left.size(), CV_32FC1, mapr0, mapr1);
-
-    cv::Mat rgb_left_rect;
-    cv::Mat rgb_right_rect;
-    cv::remap(rgb_left, rgb_left_rect, mapl0, mapl1, cv::INTER_LINEAR);
-    cv::remap(rgb_right, rgb_right_rect, mapr0, mapr1, cv::INTER_LINEAR);
-
-    /* Compute disparity. */
-    cv::Mat disparity;
-    sgbm_->compute(rgb_left_rect, rgb_right_rect, disparity);
-
-    /* Compute mapping from coordinates in the original left image to coordinates in the rectified left image. */
-    cv::Mat map(disparity.rows * disparity.cols, 1, CV_32FC2);
-    for (int v = 0; v < disparity.rows; v++)
+    if (is_stereo_synchronized())
     {
-        for (int u = 0; u < disparity.cols; u++)
+        YarpStereoSynchronizer::StereoPair pair;
+        std::tie(valid_rgb, pair) = rgb_pair(blocking);
+        if (!valid_rgb)
+            return std::make_pair(false, nullptr);
+
+        frame->left = pair.left;
+        frame->right = pair.right;
+        frame->valid_timestamp = true;
+        frame->timestamp = pair.left_timestamp;
+    }
+    else
+    {
+        std::tie(valid_rgb, frame->left) = get_relative_camera().rgb(blocking);
+        if (!valid_rgb)
+            return std::make_pair(false, nullptr);
+        std::tie(frame->valid_timestamp, frame->timestamp) = get_relative_camera().rgb_timestamp();
+
+        valid_rgb = false;
+        std::tie(valid_rgb, frame->right) = iCubCamera::rgb(blocking);
+        if (!valid_rgb)
+            return std::make_pair(false, nullptr);
+    }
+
+    /* Get the poses of both cameras once, aligned with the synchronized pair if available, and evaluate the extrinsics. */
+    bool valid_poses = false;
+    Transform<double, 3, Affine> pose_right;
+    if (is_stereo_synchronized())
+        std::tie(valid_poses, frame->pose, pose_right) = stereo_poses_at(frame->timestamp);
+    else
+        std::tie(valid_poses, frame->pose, pose_right) = stereo_poses();
+    if (!valid_poses)
+        return std::make_pair(false, nullptr);
+
+    frame->extrinsics = frame->pose.inverse() * pose_right;
+    std::tie(frame->valid_pose_timestamp, frame->pose_timestamp) = encoders_snapshot_timestamp();
+    frame->sequence = ++stereo_frame_sequence_;
+
+    return std::make_pair(true, frame);
+}
+
+
+void iCubCameraDepth::drop_stereo_frame()
+{
+    stereo_frame_.reset();
+}
+
+
+bool iCubCameraDepth::stereo_depth(const StereoFrame& frame, const bool& evaluate_confidence, MatrixXf& depth, MatrixXf& confidence)
+{
+    const cv::Mat& rgb_left = frame.left;
+    const cv::Mat& rgb_right = frame.right;
+
+    /* Rectification depends only on the extrinsics and on the image size, hence it is evaluated again only if they change. */
+    if (!rectification_valid_ || (frame.extrinsics.matrix() != rectification_extrinsics_.matrix()) || (rgb_left.size() != rectification_size_))
+    {
+        /* Get the extrinsic matrix, inverted as required by SGBM. */
+        Transform<double, 3, Affine> pose = frame.extrinsics.inverse();
+
+        /* Set the extrinsic matrix in OpenCV format. */
+        MatrixXd translation = pose.translation();
+        cv::Mat R;
+        cv::Mat t;
+        cv::eigen2cv(translation, t);
+        cv::eigen2cv(pose.rotation(), R);
+
+        /* Perform rectification. */
+        cv::stereoRectify(intrinsic_left_, distortion_left_,
+                          intrinsic_right_, distortion_right_,
+                          rgb_left.size(),
+                          R, t,
+                          R1_, R2_, P1_, P2_, Q_, -1);
+
+        cv::initUndistortRectifyMap(intrinsic_left_, distortion_left_, R1_, P1_, rgb_left.size(), CV_32FC1, mapl0_, mapl1_);
+        cv::initUndistortRectifyMap(intrinsic_right_, distortion_right_, R2_, P2_, rgb_left.size(), CV_32FC1, mapr0_, mapr1_);
+
+        /* Compute mapping from coordinates in the original left image to coordinates in the rectified left image. */
+        map_.create(rgb_left.rows * rgb_left.cols, 1, CV_32FC2);
+        for (int v = 0; v < rgb_left.rows; v++)
         {
-            map.ptr<float>(v * disparity.cols + u)[0] = float(u);
-            map.ptr<float>(v * disparity.cols + u)[1] = float(v);
+            for (int u = 0; u < rgb_left.cols; u++)
+            {
+                map_.ptr<float>(v * rgb_left.cols + u)[0] = float(u);
+                map_.ptr<float>(v * rgb_left.cols + u)[1] = float(v);
+            }
         }
+        cv::undistortPoints(map_, map_, intrinsic_left_, distortion_left_, R1_, P1_);
+
+        rectification_extrinsics_ = frame.extrinsics;
+        rectification_size_ = rgb_left.size();
+        rectification_valid_ = true;
+        valid_disparity_ = false;
+    }
+
+    const cv::Mat& R1 = R1_;
+    const cv::Mat& Q = Q_;
+    const cv::Mat& map = map_;
+
+    /* Compute disparity, once per stereo frame, such that depth and confidence of the same frame share it. */
+    cv::Mat& disparity = disparity_;
+    if (!valid_disparity_ || (frame.sequence != disparity_sequence_))
+    {
+        cv::remap(rgb_left, rgb_left_rect_, mapl0_, mapl1_, cv::INTER_LINEAR);
+        cv::remap(rgb_right, rgb_right_rect_, mapr0_, mapr1_, cv::INTER_LINEAR);
+
+        sgbm_->compute(rgb_left_rect_, rgb_right_rect_, disparity);
+
+        disparity_sequence_ = frame.sequence;
+        valid_disparity_ = true;
     }
-    cv::undistortPoints(map, map, intrinsic_left_, distortion_left_, R1, P1);
 
     /* Store some values required for the next computation. */
     float q_00 = float(Q.at<double>(0, 0));
@@ -153,8 +412,15 @@ std::pair<bool, Eigen::MatrixXf> iCubCameraDepth::depth(const bool& blocking)
     float r_12 = float(R1.at<double>(1, 2));
     float r_22 = float(R1.at<double>(2, 2));
 
-    /* Compute depth. */
-    MatrixXf depth(rgb_left.rows, rgb_left.cols);
+    /* Disparities below this value are those invalidated by SGBM. */
+    const short minimum_valid_disparity = short(min_disparity_ * 16);
+
+    /* Compute depth and, if required, the confidence map, reusing the storage of the outputs. */
+    depth.resize(rgb_left.rows, rgb_left.cols);
+    if (evaluate_confidence)
+        confidence.resize(rgb_left.rows, rgb_left.cols);
+    else
+        confidence.resize(0, 0);
 #pragma omp parallel for collapse(2)
     for (int v = 0; v < rgb_left.rows; v++)
         for (int u = 0; u < rgb_left.cols; u++)
@@ -170,31 +436,23 @@ std::pair<bool, Eigen::MatrixXf> iCubCameraDepth::depth(const bool& blocking)
             if ((u_r < 0) || (u_r >= disparity.cols) || (v_r < 0) || ( v_r >= disparity.rows))
             {
                 depth(v, u) = std::numeric_limits<double>::infinity();
+                if (evaluate_confidence)
+                    confidence(v, u) = 0.0;
                 continue;
             }
 
             /* Get disparity. */
-            float disparity_value = disparity.at<short>(v_r, u_r) / 16.0;
+            short disparity_raw = disparity.at<short>(v_r, u_r);
+            float disparity_value = disparity_raw / 16.0;
+
+            if (evaluate_confidence)
+                confidence(v, u) = ((disparity_raw >= minimum_valid_disparity) && (disparity_value > 0)) ? 1.0 : 0.0;
 
             /* Evaluate depth. */
             depth(v, u) = (r_02 * (float(u_r) * q_00 + q_03) + r_12 * (float(v_r) * q_11 + q_13) + r_22 * q_23) / (disparity_value * q_32 + q_33);
         }
 
-    return std::make_pair(true, depth);
-}
-
-
-std::pair<bool, Eigen::Transform<double, 3, Eigen::Affine>> iCubCameraDepth::pose(const bool& blocking)
-{
-    /* Since the depth is aligned with left camera, the left camera pose is returned here. */
-    return get_relative_camera().pose(blocking);
-}
-
-
-std::pair<bool, cv::Mat> iCubCameraDepth::rgb(const bool& blocking)
-{
-    /* Since the depth is aligned with left camera, the left image is returned here. */
-    return get_relative_camera().rgb(blocking);
+    return true;
 }
 
 
@@ -19,7 +19,8 @@ iCubCameraRelative::iCubCameraRelative
     const bool& use_calibration,
     const std::string& calibration_path
 ) :
-    iCubCamera(robot_name, "right", port_prefix + "_relative_right", fallback_context_name, fallback_configuration_name, use_calibration, calibration_path)
+    iCubCamera(robot_name, "right", port_prefix + "_relative_right", fallback_context_name, fallback_configuration_name, use_calibration, calibration_path),
+    port_prefix_(port_prefix)
 {
     /* Initialize left camera. */
     left_camera_= std::unique_ptr<iCubCamera>
@@ -86,6 +87,44 @@ bool iCubCameraRelative::set_frame_index(const std::int32_t& index)
 }
 
 
+bool iCubCameraRelative::enable_stereo_synchronization(const double& tolerance, const std::size_t& buffer_size)
+{
+    if (is_offline())
+        return false;
+
+    stereo_synchronizer_ = std::unique_ptr<YarpStereoSynchronizer>
+    (
+        new YarpStereoSynchronizer(port_prefix_ + "_relative_stereo", tolerance, buffer_size)
+    );
+
+    return true;
+}
+
+
+std::pair<bool, YarpStereoSynchronizer::StereoPair> iCubCameraRelative::rgb_pair(const bool& blocking)
+{
+    if (!is_stereo_synchronized())
+        return std::make_pair(false, YarpStereoSynchronizer::StereoPair());
+
+    return stereo_synchronizer_->pair(blocking);
+}
+
+
+std::pair<bool, YarpStereoSynchronizer::Statistics> iCubCameraRelative::stereo_synchronization_statistics() const
+{
+    if (!is_stereo_synchronized())
+        return std::make_pair(false, YarpStereoSynchronizer::Statistics());
+
+    return std::make_pair(true, stereo_synchronizer_->statistics());
+}
+
+
+bool iCubCameraRelative::is_stereo_synchronized() const
+{
+    return (stereo_synchronizer_ != nullptr);
+}
+
+
 RobotsIO::Camera::iCubCamera& iCubCameraRelative::get_relative_camera()
 {
     return *left_camera_;
@@ -100,16 +139,11 @@ const RobotsIO::Camera::iCubCamera& iCubCameraRelative::get_relative_camera() co
 
 std::pair<bool, Eigen::Transform<double, 3, Eigen::Affine>> iCubCameraRelative::pose(const bool& blocking)
 {
-    bool valid_left = false;
+    bool valid_poses = false;
     Eigen::Transform<double, 3, Eigen::Affine> pose_left;
-    std::tie(valid_left, pose_left) = get_relative_camera().pose(false);
-    if (!valid_left)
-        return std::make_pair(false, Eigen::Transform<double, 3, Eigen::Affine>());
-
-    bool valid_right = false;
     Eigen::Transform<double, 3, Eigen::Affine> pose_right;
-    std::tie(valid_right, pose_right) = iCubCamera::pose(false);
-    if (!valid_right)
+    std::tie(valid_poses, pose_left, pose_right) = stereo_poses();
+    if (!valid_poses)
         return std::make_pair(false, Eigen::Transform<double, 3, Eigen::Affine>());
 
     /* Evaluate the relative pose from left camera to right camera . */
@@ -118,3 +152,48 @@ std::pair<bool, Eigen::Transform<double, 3, Eigen::Affine>> iCubCameraRelative::
 
     return std::make_pair(true, pose_relative);
 }
+
+
+std::tuple<bool, Eigen::Transform<double, 3, Eigen::Affine>, Eigen::Transform<double, 3, Eigen::Affine>> iCubCameraRelative::stereo_poses()
+{
+    /* Encoders are read once and shared by both cameras. */
+    EncodersSnapshot snapshot;
+    if (requires_encoders())
+    {
+        bool valid_snapshot = false;
+        std::tie(valid_snapshot, snapshot) = acquire_encoders_snapshot(pose_snapshot_consumed_);
+    }
+
+    return stereo_poses_from_encoders(snapshot);
+}
+
+
+std::tuple<bool, Eigen::Transform<double, 3, Eigen::Affine>, Eigen::Transform<double, 3, Eigen::Affine>> iCubCameraRelative::stereo_poses_at(const double& timestamp)
+{
+    EncodersSnapshot snapshot;
+    if (requires_encoders())
+    {
+        bool valid_snapshot = false;
+        std::tie(valid_snapshot, snapshot) = acquire_encoders_snapshot_at(timestamp, pose_snapshot_consumed_);
+    }
+
+    return stereo_poses_from_encoders(snapshot);
+}
+
+
+std::tuple<bool, Eigen::Transform<double, 3, Eigen::Affine>, Eigen::Transform<double, 3, Eigen::Affine>> iCubCameraRelative::stereo_poses_from_encoders(const EncodersSnapshot& snapshot)
+{
+    bool valid_left = false;
+    Eigen::Transform<double, 3, Eigen::Affine> pose_left;
+    std::tie(valid_left, pose_left) = get_relative_camera().pose_from_encoders(snapshot);
+    if (!valid_left)
+        return std::make_tuple(false, Eigen::Transform<double, 3, Eigen::Affine>(), Eigen::Transform<double, 3, Eigen::Affine>());
+
+    bool valid_right = false;
+    Eigen::Transform<double, 3, Eigen::Affine> pose_right;
+    std::tie(valid_right, pose_right) = pose_from_encoders(snapshot);
+    if (!valid_right)
+        return std::make_tuple(false, Eigen::Transform<double, 3, Eigen::Affine>(), Eigen::Transform<double, 3, Eigen::Affine>());
+
+    return std::make_tuple(true, pose_left, pose_right);
+}
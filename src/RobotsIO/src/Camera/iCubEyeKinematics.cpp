@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <RobotsIO/Camera/iCubEyeKinematics.h>
+
+#include <cmath>
+#include <stdexcept>
+
+#include <iCub/iKin/iKinFwd.h>
+
+#include <yarp/eigen/Eigen.h>
+
+using namespace Eigen;
+using namespace RobotsIO::Camera;
+using namespace iCub::iKin;
+
+
+constexpr std::size_t iCubEyeKinematics::number_of_links;
+
+
+iCubEyeKinematics::iCubEyeKinematics(const std::string& type)
+{
+    if (type.find("left") == 0)
+        is_left_ = true;
+    else if (type.find("right") == 0)
+        is_left_ = false;
+    else
+        throw(std::runtime_error(log_name_ + "::ctor. Error: invalid eye type " + type + "."));
+
+    /* Take the kinematic description from iKin. */
+    iCubEye eye(type);
+    if (eye.getN() != number_of_links)
+        throw(std::runtime_error(log_name_ + "::ctor. Error: unexpected number of links for eye type " + type + "."));
+
+    H0_ = yarp::eigen::toEigen(eye.getH0());
+    HN_ = yarp::eigen::toEigen(eye.getHN());
+
+    for (std::size_t i = 0; i < number_of_links; i++)
+    {
+        const iKinLink& link = eye[i];
+
+        a_(i) = link.getA();
+        d_(i) = link.getD();
+        cos_alpha_(i) = std::cos(link.getAlpha());
+        sin_alpha_(i) = std::sin(link.getAlpha());
+        offset_(i) = link.getOffset();
+    }
+}
+
+
+Transform<double, 3, Affine> iCubEyeKinematics::pose(const Joints& joints) const
+{
+    Matrix4d H = H0_;
+
+    for (std::size_t i = 0; i < number_of_links; i++)
+    {
+        const double theta = joints(i) + offset_(i);
+        const double cos_theta = std::cos(theta);
+        const double sin_theta = std::sin(theta);
+
+        /* Denavit-Hartenberg transformation of the i-th link, as in iCub::iKin::iKinLink::getH(). */
+        Matrix4d H_i;
+        H_i << cos_theta, -sin_theta * cos_alpha_(i),  sin_theta * sin_alpha_(i), cos_theta * a_(i),
+               sin_theta,  cos_theta * cos_alpha_(i), -cos_theta * sin_alpha_(i), sin_theta * a_(i),
+               0.0,        sin_alpha_(i),              cos_alpha_(i),             d_(i),
+               0.0,        0.0,                        0.0,                       1.0;
+
+        H = H * H_i;
+    }
+
+    Transform<double, 3, Affine> pose;
+    pose.matrix() = H * HN_;
+
+    return pose;
+}
+
+
+Transform<double, 3, Affine> iCubEyeKinematics::pose_from_encoders(const Ref<const Vector3d>& torso, const Ref<const Matrix<double, 6, 1>>& head) const
+{
+    return pose(joints_from_encoders(torso, head));
+}
+
+
+iCubEyeKinematics::Poses iCubEyeKinematics::poses_from_encoders(const Ref<const MatrixXd>& encoders) const
+{
+    if (encoders.rows() != Encoders::RowsAtCompileTime)
+        throw(std::runtime_error(log_name_ + "::poses_from_encoders. Error: encoders should have 9 rows."));
+
+    Poses poses(encoders.cols());
+
+#pragma omp parallel for
+    for (int i = 0; i < encoders.cols(); i++)
+    {
+        Encoders column = encoders.col(i);
+        poses[i] = pose_from_encoders(column.head<3>(), column.tail<6>());
+    }
+
+    return poses;
+}
+
+
+iCubEyeKinematics::Joints iCubEyeKinematics::joints_from_encoders(const Ref<const Vector3d>& torso, const Ref<const Matrix<double, 6, 1>>& head) const
+{
+    /* The torso joints are reversed in the chain. */
+    Joints joints;
+    joints(0) = torso(2);
+    joints(1) = torso(1);
+    joints(2) = torso(0);
+    joints.segment<4>(3) = head.head<4>();
+
+    /* Eye pan from version and vergence. */
+    const double version = head(4);
+    const double vergence = head(5);
+    if (is_left_)
+        joints(7) = version + vergence / 2.0;
+    else
+        joints(7) = version - vergence / 2.0;
+
+    return joints * M_PI / 180.0;
+}
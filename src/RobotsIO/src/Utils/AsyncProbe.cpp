@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#include <RobotsIO/Utils/AsyncProbe.h>
+
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+
+using namespace RobotsIO::Utils;
+
+
+AsyncProbe::AsyncProbe(std::unique_ptr<Probe> probe, const std::size_t& capacity, const Policy& policy) :
+    probe_(std::move(probe)),
+    policy_(policy),
+    slots_(capacity),
+    enqueued_(0),
+    dispatched_(0),
+    dropped_(0),
+    failed_(0)
+{
+    if (probe_ == nullptr)
+        throw(std::runtime_error(log_name_ + "::ctor. Error: the wrapped probe is not valid."));
+
+    if (capacity == 0)
+        throw(std::runtime_error(log_name_ + "::ctor. Error: the capacity of the queue should be positive."));
+
+    worker_ = std::thread(&AsyncProbe::run, this);
+}
+
+
+AsyncProbe::~AsyncProbe()
+{
+    stop();
+}
+
+
+AsyncProbe::Counters AsyncProbe::counters() const
+{
+    Counters counters;
+    counters.enqueued = enqueued_;
+    counters.dispatched = dispatched_;
+    counters.dropped = dropped_;
+    counters.failed = failed_;
+
+    return counters;
+}
+
+
+std::unique_ptr<Probe> AsyncProbe::release()
+{
+    stop();
+
+    return std::move(probe_);
+}
+
+
+void AsyncProbe::on_new_data()
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        if (size_ == slots_.size())
+        {
+            if (policy_ == Policy::DropNewest)
+            {
+                dropped_++;
+                statistics_.add_dropped();
+                return;
+            }
+            else if (policy_ == Policy::DropOldest)
+            {
+                head_ = (head_ + 1) % slots_.size();
+                size_--;
+                dropped_++;
+                statistics_.add_dropped();
+            }
+            else
+            {
+                not_full_.wait(lock, [this]{ return (size_ < slots_.size()) || !running_; });
+                if (size_ == slots_.size())
+                {
+                    dropped_++;
+                    statistics_.add_dropped();
+                    return;
+                }
+            }
+        }
+
+        /* Swapping leaves the previous content of the slot to the probe, which can reuse its storage the next time data is set. */
+        slots_[(head_ + size_) % slots_.size()].swap(get_data());
+        size_++;
+        enqueued_++;
+    }
+
+    not_empty_.notify_one();
+}
+
+
+void AsyncProbe::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        running_ = false;
+    }
+    not_empty_.notify_all();
+    not_full_.notify_all();
+
+    if (worker_.joinable())
+        worker_.join();
+}
+
+
+void AsyncProbe::run()
+{
+    Data data;
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+
+            not_empty_.wait(lock, [this]{ return (size_ > 0) || !running_; });
+            if (size_ == 0)
+                return;
+
+            data.swap(slots_[head_]);
+            head_ = (head_ + 1) % slots_.size();
+            size_--;
+        }
+
+        not_full_.notify_one();
+
+        /* Exceptions cannot propagate to the caller, hence they are counted and only the first one is reported. */
+        try
+        {
+            probe_->set_data(data);
+        }
+        catch (const std::exception& exception)
+        {
+            if (failed_++ == 0)
+                std::cerr << log_name_ + "::run. Error: the wrapped probe threw (" << exception.what() << "), further failures are only counted." << std::endl;
+        }
+        catch (...)
+        {
+            if (failed_++ == 0)
+                std::cerr << log_name_ + "::run. Error: the wrapped probe threw, further failures are only counted." << std::endl;
+        }
+
+        dispatched_++;
+    }
+}
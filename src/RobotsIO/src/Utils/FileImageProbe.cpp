@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#include <RobotsIO/Utils/FileImageProbe.h>
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+using namespace RobotsIO::Utils;
+
+
+FileImageProbe::FileImageProbe(const std::string& path, const Codec& codec, const int& quality, const std::size_t& batch_size) :
+    writer_(path, batch_size),
+    codec_(codec)
+{
+    if (quality >= 0)
+    {
+        if (codec_ == Codec::Png)
+            parameters_ = {cv::IMWRITE_PNG_COMPRESSION, quality};
+        else if (codec_ == Codec::Jpeg)
+            parameters_ = {cv::IMWRITE_JPEG_QUALITY, quality};
+    }
+}
+
+
+FileImageProbe::~FileImageProbe()
+{}
+
+
+bool FileImageProbe::flush()
+{
+    return writer_.flush();
+}
+
+
+void FileImageProbe::on_new_typed_data(const cv::Mat& data)
+{
+    const double timestamp = FileRecordWriter::now();
+
+    const std::int32_t header[4] = {static_cast<std::int32_t>(codec_), data.rows, data.cols, data.type()};
+
+    if (codec_ == Codec::Raw)
+    {
+        const std::size_t row_size = data.cols * data.elemSize();
+
+        if (data.isContinuous())
+        {
+            if (!writer_.write(timestamp, reinterpret_cast<const char*>(header), sizeof(header), reinterpret_cast<const char*>(data.data), data.rows * row_size))
+                throw(std::runtime_error(log_name_ + "::on_new_typed_data. Error: cannot write to disk."));
+            return;
+        }
+
+        /* Padding is removed. */
+        buffer_.resize(data.rows * row_size);
+        for (int i = 0; i < data.rows; i++)
+            std::memcpy(buffer_.data() + i * row_size, data.ptr(i), row_size);
+    }
+    else
+        cv::imencode(codec_ == Codec::Png ? ".png" : ".jpg", data, buffer_, parameters_);
+
+    if (!writer_.write(timestamp, reinterpret_cast<const char*>(header), sizeof(header), reinterpret_cast<const char*>(buffer_.data()), buffer_.size()))
+        throw(std::runtime_error(log_name_ + "::on_new_typed_data. Error: cannot write to disk."));
+}
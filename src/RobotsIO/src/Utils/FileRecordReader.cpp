@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#include <RobotsIO/Utils/FileImageProbe.h>
+#include <RobotsIO/Utils/FileRecordReader.h>
+
+#include <cstring>
+#include <stdexcept>
+
+using namespace Eigen;
+using namespace RobotsIO::Utils;
+
+
+FileRecordReader::FileRecordReader(const std::string& path)
+{
+    log_.open(path, std::ios::binary | std::ios::in);
+    if (!log_.is_open())
+        throw(std::runtime_error(log_name_ + "::ctor. Error: cannot open file " + path + "."));
+
+    std::ifstream index(path + ".index", std::ios::binary | std::ios::in);
+    if (!index.is_open())
+        throw(std::runtime_error(log_name_ + "::ctor. Error: cannot open file " + path + ".index."));
+
+    Entry entry;
+    while (index.read(reinterpret_cast<char*>(&entry.timestamp), sizeof(double)) &&
+           index.read(reinterpret_cast<char*>(&entry.offset), sizeof(std::uint64_t)) &&
+           index.read(reinterpret_cast<char*>(&entry.size), sizeof(std::uint64_t)))
+        entries_.push_back(entry);
+}
+
+
+FileRecordReader::~FileRecordReader()
+{}
+
+
+std::size_t FileRecordReader::number_records() const
+{
+    return entries_.size();
+}
+
+
+std::pair<bool, double> FileRecordReader::timestamp(const std::size_t& index) const
+{
+    if (index >= entries_.size())
+        return std::make_pair(false, 0.0);
+
+    return std::make_pair(true, entries_.at(index).timestamp);
+}
+
+
+bool FileRecordReader::read(const std::size_t& index, double& timestamp, std::vector<char>& data)
+{
+    if (index >= entries_.size())
+        return false;
+
+    const Entry& entry = entries_.at(index);
+
+    data.resize(entry.size);
+    log_.clear();
+    log_.seekg(entry.offset);
+    if (!log_.read(data.data(), entry.size))
+        return false;
+
+    timestamp = entry.timestamp;
+
+    return true;
+}
+
+
+bool FileRecordReader::read_matrix(const std::size_t& index, double& timestamp, MatrixXd& data)
+{
+    if (!read(index, timestamp, record_))
+        return false;
+
+    std::uint64_t shape[2];
+    if (record_.size() < sizeof(shape))
+        return false;
+    std::memcpy(shape, record_.data(), sizeof(shape));
+
+    /* The shape is checked against the size of the payload by dividing, such that the check cannot overflow. */
+    const std::size_t payload_size = record_.size() - sizeof(shape);
+    if (payload_size % sizeof(double) != 0)
+        return false;
+
+    const std::uint64_t number_values = payload_size / sizeof(double);
+    if ((shape[0] == 0) || (shape[1] == 0))
+    {
+        if (number_values != 0)
+            return false;
+    }
+    else if ((number_values % shape[0] != 0) || (number_values / shape[0] != shape[1]))
+        return false;
+
+    data.resize(shape[0], shape[1]);
+    std::memcpy(data.data(), record_.data() + sizeof(shape), data.size() * sizeof(double));
+
+    return true;
+}
+
+
+bool FileRecordReader::read_image(const std::size_t& index, double& timestamp, cv::Mat& image)
+{
+    if (!read(index, timestamp, record_))
+        return false;
+
+    std::int32_t header[4];
+    if (record_.size() < sizeof(header))
+        return false;
+    std::memcpy(header, record_.data(), sizeof(header));
+
+    const std::size_t payload_size = record_.size() - sizeof(header);
+    unsigned char* payload = reinterpret_cast<unsigned char*>(record_.data() + sizeof(header));
+
+    if (header[0] == static_cast<std::int32_t>(FileImageProbe::Codec::Raw))
+    {
+        image.create(header[1], header[2], header[3]);
+        if (payload_size != image.total() * image.elemSize())
+            return false;
+
+        std::memcpy(image.data, payload, payload_size);
+    }
+    else
+    {
+        image = cv::imdecode(cv::Mat(1, payload_size, CV_8UC1, payload), cv::IMREAD_UNCHANGED);
+        if (image.empty())
+            return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#include <RobotsIO/Utils/FileRecordWriter.h>
+
+#include <chrono>
+#include <stdexcept>
+
+using namespace RobotsIO::Utils;
+
+
+FileRecordWriter::FileRecordWriter(const std::string& path, const std::size_t& batch_size) :
+    batch_size_(batch_size)
+{
+    /* Writing waits for the pending data to be smaller than four batches, hence an empty batch would block it forever. */
+    if (batch_size_ == 0)
+        throw(std::runtime_error(log_name_ + "::ctor. Error: the size of the batch should be positive."));
+
+    log_.open(path, std::ios::binary | std::ios::out | std::ios::trunc);
+    if (!log_.is_open())
+        throw(std::runtime_error(log_name_ + "::ctor. Error: cannot open file " + path + "."));
+
+    index_.open(path + ".index", std::ios::binary | std::ios::out | std::ios::trunc);
+    if (!index_.is_open())
+        throw(std::runtime_error(log_name_ + "::ctor. Error: cannot open file " + path + ".index."));
+
+    pending_log_.reserve(batch_size_);
+
+    worker_ = std::thread(&FileRecordWriter::run, this);
+}
+
+
+FileRecordWriter::~FileRecordWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        running_ = false;
+    }
+    pending_.notify_all();
+
+    /* Pending records are written before the worker terminates. */
+    worker_.join();
+}
+
+
+bool FileRecordWriter::write(const double& timestamp, const char* data, const std::size_t& size, const char* data_tail, const std::size_t& size_tail)
+{
+    bool notify = false;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        written_.wait(lock, [this]{ return pending_log_.size() < 4 * batch_size_; });
+
+        if (failed_)
+            return false;
+
+        const std::uint64_t offset = number_bytes_;
+        const std::uint64_t record_size = size + size_tail;
+
+        pending_log_.insert(pending_log_.end(), data, data + size);
+        if (data_tail != nullptr)
+            pending_log_.insert(pending_log_.end(), data_tail, data_tail + size_tail);
+
+        auto append_to_index = [this](const char* value, const std::size_t& size)
+        {
+            pending_index_.insert(pending_index_.end(), value, value + size);
+        };
+        append_to_index(reinterpret_cast<const char*>(&timestamp), sizeof(double));
+        append_to_index(reinterpret_cast<const char*>(&offset), sizeof(std::uint64_t));
+        append_to_index(reinterpret_cast<const char*>(&record_size), sizeof(std::uint64_t));
+
+        number_records_++;
+        number_bytes_ += record_size;
+
+        notify = (pending_log_.size() >= batch_size_);
+    }
+
+    if (notify)
+        pending_.notify_one();
+
+    return true;
+}
+
+
+bool FileRecordWriter::flush()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    flush_requested_ = true;
+    pending_.notify_one();
+
+    const std::uint64_t number_bytes = number_bytes_;
+    written_.wait(lock, [this, number_bytes]{ return failed_ || (number_bytes_written_ >= number_bytes); });
+
+    return !failed_;
+}
+
+
+std::uint64_t FileRecordWriter::number_records() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    return number_records_;
+}
+
+
+std::uint64_t FileRecordWriter::number_bytes() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    return number_bytes_;
+}
+
+
+double FileRecordWriter::now()
+{
+    return std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+
+void FileRecordWriter::run()
+{
+    std::vector<char> log;
+    std::vector<char> index;
+    log.reserve(batch_size_);
+
+    while (true)
+    {
+        bool terminate = false;
+        std::uint64_t number_bytes;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+
+            pending_.wait_for(lock, std::chrono::milliseconds(100), [this]{ return !running_ || flush_requested_ || (pending_log_.size() >= batch_size_); });
+
+            /* Buffers are swapped, such that writing to disk does not hold the lock. */
+            log.swap(pending_log_);
+            index.swap(pending_index_);
+            number_bytes = number_bytes_;
+            flush_requested_ = false;
+            terminate = !running_;
+        }
+
+        bool failed = false;
+        if (!index.empty())
+        {
+            log_.write(log.data(), log.size());
+            index_.write(index.data(), index.size());
+            log_.flush();
+            index_.flush();
+
+            /* Streams stay failed, such that records are not written past a missing one. */
+            failed = !log_.good() || !index_.good();
+
+            log.clear();
+            index.clear();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            number_bytes_written_ = number_bytes;
+            failed_ = failed_ || failed;
+        }
+        written_.notify_all();
+
+        if (terminate)
+            return;
+    }
+}
@@ -7,6 +7,8 @@
 
 #include <RobotsIO/Utils/Probe.h>
 
+#include <chrono>
+
 using namespace RobotsIO::Utils;
 
 
@@ -16,10 +18,20 @@ Probe::~Probe()
 
 void Probe::set_data(const Data& data)
 {
+    statistics_.add_call();
+
+    if (!is_data_accepted())
+    {
+        statistics_.add_dropped();
+        return;
+    }
+
     data_ = data;
 
     /* Signal that new data has been set. */
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
     on_new_data();
+    statistics_.add_publish(std::chrono::steady_clock::now() - start);
 }
 
 
@@ -27,3 +39,42 @@ Data& Probe::get_data()
 {
     return data_;
 }
+
+
+const ProbeStatistics& Probe::statistics() const
+{
+    return statistics_;
+}
+
+
+void Probe::set_throttle(std::unique_ptr<ProbeThrottle> throttle)
+{
+    throttle_ = std::move(throttle);
+}
+
+
+ProbeThrottle* Probe::get_throttle()
+{
+    return throttle_.get();
+}
+
+
+std::unique_ptr<ProbeThrottle> Probe::release_throttle()
+{
+    return std::move(throttle_);
+}
+
+
+bool Probe::accept_data()
+{
+    return true;
+}
+
+
+bool Probe::is_data_accepted()
+{
+    if ((throttle_ != nullptr) && !throttle_->accept())
+        return false;
+
+    return accept_data();
+}
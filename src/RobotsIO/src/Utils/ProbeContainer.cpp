@@ -7,6 +7,10 @@
 
 #include <RobotsIO/Utils/ProbeContainer.h>
 
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
 using namespace RobotsIO::Utils;
 
 
@@ -16,16 +20,165 @@ ProbeContainer::~ProbeContainer()
 
 bool ProbeContainer::is_probe(const std::string& name)
 {
-    return (probes_.find(name) != probes_.end());
+    /* Probes referenced by a handle might have not been set yet. */
+    auto probe = probes_.find(name);
+
+    return (probe != probes_.end()) && (probe->second != nullptr);
 }
 
 
 Probe& ProbeContainer::get_probe(const std::string& name)
 {
-    return *(probes_.at(name));
+    std::unique_ptr<Probe>& probe = probes_.at(name);
+    if (probe == nullptr)
+        throw(std::out_of_range(log_name_ + "::get_probe. Error: probe " + name + " is not set."));
+
+    return *probe;
 }
 
 void ProbeContainer::set_probe(const std::string& name, std::unique_ptr<Probe> probe)
 {
+    auto policy = policies_.find(name);
+    if ((policy != policies_.end()) && (probe != nullptr))
+        probe = apply_policy(std::move(probe), policy->second);
+
     probes_[name] = std::move(probe);
 }
+
+
+void ProbeContainer::set_probe_policy(const std::string& name, const ProbeThrottle::Policy& policy)
+{
+    if (policy.decimation == 0)
+        throw(std::runtime_error(log_name_ + "::set_probe_policy. Error: the decimation should be positive."));
+
+    auto previous_policy = policies_.find(name);
+    const bool coalesced = (previous_policy != policies_.end()) && previous_policy->second.coalesce;
+
+    policies_[name] = policy;
+
+    auto probe = probes_.find(name);
+    if ((probe == probes_.end()) || (probe->second == nullptr))
+        return;
+
+    ProbeThrottle* throttle = probe->second->get_throttle();
+    if ((throttle != nullptr) && (coalesced == policy.coalesce))
+    {
+        /* The counters of the throttle are preserved. */
+        throttle->set_policy(policy);
+        return;
+    }
+
+    if (coalesced)
+    {
+        /* The probe was wrapped by the AsyncProbe when the previous policy was applied, hence it is unwrapped before applying the new one. */
+        probe->second = static_cast<AsyncProbe&>(*(probe->second)).release();
+    }
+
+    probe->second = apply_policy(std::move(probe->second), policy);
+}
+
+
+ProbeHandle ProbeContainer::get_probe_handle(const std::string& name)
+{
+    /* Elements of the map are never moved, hence the handle stays valid. */
+    return ProbeHandle(&probes_[name]);
+}
+
+
+std::map<std::string, ProbeStatistics::Snapshot> ProbeContainer::probe_statistics() const
+{
+    std::map<std::string, ProbeStatistics::Snapshot> statistics;
+
+    for (const auto& probe : probes_)
+    {
+        if (probe.second != nullptr)
+            statistics[probe.first] = probe.second->statistics().snapshot();
+    }
+
+    return statistics;
+}
+
+
+std::string ProbeContainer::probe_statistics_to_text() const
+{
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(1);
+
+    for (const auto& item : probe_statistics())
+    {
+        const ProbeStatistics::Snapshot& snapshot = item.second;
+
+        text << item.first
+             << " calls=" << snapshot.calls
+             << " dropped=" << snapshot.dropped
+             << " bytes=" << snapshot.bytes
+             << " p50=" << snapshot.duration_p50 * 1e6 << "us"
+             << " p99=" << snapshot.duration_p99 * 1e6 << "us"
+             << " last=" << std::setprecision(6) << snapshot.last_publish_time << std::setprecision(1)
+             << std::endl;
+    }
+
+    return text.str();
+}
+
+
+std::string ProbeContainer::probe_statistics_to_json() const
+{
+    std::ostringstream json;
+    json << std::setprecision(17);
+
+    json << "{";
+
+    bool first = true;
+    for (const auto& item : probe_statistics())
+    {
+        const ProbeStatistics::Snapshot& snapshot = item.second;
+
+        std::ostringstream name;
+        for (const char& c : item.first)
+        {
+            if ((c == '"') || (c == '\\'))
+                name << '\\' << c;
+            else if (c == '\n')
+                name << "\\n";
+            else if (c == '\t')
+                name << "\\t";
+            else if (static_cast<unsigned char>(c) < 0x20)
+                name << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+            else
+                name << c;
+        }
+
+        if (!first)
+            json << ", ";
+        first = false;
+
+        json << "\"" << name.str() << "\": {"
+             << "\"calls\": " << snapshot.calls << ", "
+             << "\"dropped\": " << snapshot.dropped << ", "
+             << "\"bytes\": " << snapshot.bytes << ", "
+             << "\"duration_p50\": " << snapshot.duration_p50 << ", "
+             << "\"duration_p99\": " << snapshot.duration_p99 << ", "
+             << "\"last_publish_time\": " << snapshot.last_publish_time
+             << "}";
+    }
+
+    json << "}";
+
+    return json.str();
+}
+
+
+std::unique_ptr<Probe> ProbeContainer::apply_policy(std::unique_ptr<Probe> probe, const ProbeThrottle::Policy& policy)
+{
+    if (policy.coalesce)
+    {
+        /* Data is throttled before being queued, hence only by the AsyncProbe. */
+        probe->set_throttle(nullptr);
+        probe = std::unique_ptr<Probe>(new AsyncProbe(std::move(probe), 1, AsyncProbe::Policy::DropOldest));
+    }
+
+    probe->set_throttle(std::unique_ptr<ProbeThrottle>(new ProbeThrottle(policy)));
+
+    return probe;
+}
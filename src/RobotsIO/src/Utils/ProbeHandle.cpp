@@ -0,0 +1,39 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#include <RobotsIO/Utils/ProbeHandle.h>
+
+using namespace RobotsIO::Utils;
+
+
+ProbeHandle::ProbeHandle() :
+    probe_(nullptr)
+{}
+
+
+ProbeHandle::ProbeHandle(std::unique_ptr<Probe>* probe) :
+    probe_(probe)
+{}
+
+
+bool ProbeHandle::is_probe() const
+{
+    return (probe_ != nullptr) && (*probe_ != nullptr);
+}
+
+
+void ProbeHandle::set_data(const Data& data) const
+{
+    if (is_probe())
+        (*probe_)->set_data(data);
+}
+
+
+Probe* ProbeHandle::get() const
+{
+    return is_probe() ? probe_->get() : nullptr;
+}
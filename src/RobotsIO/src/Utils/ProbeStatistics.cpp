@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#include <RobotsIO/Utils/ProbeStatistics.h>
+
+#include <opencv2/opencv.hpp>
+
+using namespace RobotsIO::Utils;
+
+
+std::size_t RobotsIO::Utils::probe_data_size(const cv::Mat& data)
+{
+    return data.total() * data.elemSize();
+}
+
+
+ProbeStatistics::ProbeStatistics()
+{
+    reset();
+}
+
+
+void ProbeStatistics::add_call()
+{
+    calls_.fetch_add(1, std::memory_order_relaxed);
+}
+
+
+void ProbeStatistics::add_dropped()
+{
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+}
+
+
+void ProbeStatistics::add_bytes(const std::size_t& bytes)
+{
+    bytes_.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+
+void ProbeStatistics::add_publish(const std::chrono::steady_clock::duration& duration)
+{
+    const std::int64_t nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+    histogram_[bucket(nanoseconds > 0 ? nanoseconds : 0)].fetch_add(1, std::memory_order_relaxed);
+
+    const std::int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    last_publish_time_.store(now, std::memory_order_relaxed);
+}
+
+
+ProbeStatistics::Snapshot ProbeStatistics::snapshot() const
+{
+    Snapshot snapshot;
+    snapshot.calls = calls_.load(std::memory_order_relaxed);
+    snapshot.dropped = dropped_.load(std::memory_order_relaxed);
+    snapshot.bytes = bytes_.load(std::memory_order_relaxed);
+    snapshot.last_publish_time = last_publish_time_.load(std::memory_order_relaxed) * 1e-9;
+
+    std::array<std::uint64_t, 256> counts;
+    std::uint64_t total = 0;
+    for (std::size_t i = 0; i < counts.size(); i++)
+    {
+        counts[i] = histogram_[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+
+    snapshot.duration_p50 = percentile(counts, total, 0.5);
+    snapshot.duration_p99 = percentile(counts, total, 0.99);
+
+    return snapshot;
+}
+
+
+void ProbeStatistics::reset()
+{
+    calls_.store(0);
+    dropped_.store(0);
+    bytes_.store(0);
+    last_publish_time_.store(0);
+    for (auto& count : histogram_)
+        count.store(0);
+}
+
+
+std::size_t ProbeStatistics::bucket(const std::uint64_t& nanoseconds)
+{
+    if (nanoseconds < 4)
+        return nanoseconds;
+
+    std::size_t exponent = 2;
+    while ((nanoseconds >> (exponent + 1)) != 0)
+        exponent++;
+
+    /* Four sub-buckets within [2^exponent, 2^(exponent + 1)). */
+    const std::size_t sub_bucket = (nanoseconds >> (exponent - 2)) & 3;
+
+    return 4 * (exponent - 1) + sub_bucket;
+}
+
+
+double ProbeStatistics::bucket_value(const std::size_t& bucket)
+{
+    if (bucket < 4)
+        return bucket * 1e-9;
+
+    const std::size_t exponent = bucket / 4 + 1;
+    const double width = static_cast<double>(std::uint64_t(1) << (exponent - 2));
+    const double lower = (4 + bucket % 4) * width;
+
+    /* Center of the bucket. */
+    return (lower + width / 2.0) * 1e-9;
+}
+
+
+double ProbeStatistics::percentile(const std::array<std::uint64_t, 256>& counts, const std::uint64_t& total, const double& fraction) const
+{
+    if (total == 0)
+        return 0.0;
+
+    const double rank = fraction * total;
+    std::uint64_t cumulative = 0;
+    for (std::size_t i = 0; i < counts.size(); i++)
+    {
+        cumulative += counts[i];
+        if (cumulative >= rank)
+            return bucket_value(i);
+    }
+
+    return bucket_value(counts.size() - 1);
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#include <RobotsIO/Utils/ProbeThrottle.h>
+
+#include <stdexcept>
+
+using namespace RobotsIO::Utils;
+
+
+ProbeThrottle::ProbeThrottle(const Policy& policy)
+{
+    set_policy(policy);
+}
+
+
+ProbeThrottle::~ProbeThrottle()
+{}
+
+
+const ProbeThrottle::Policy& ProbeThrottle::policy() const
+{
+    return policy_;
+}
+
+
+void ProbeThrottle::set_policy(const Policy& policy)
+{
+    if (policy.decimation == 0)
+        throw(std::runtime_error(log_name_ + "::set_policy. Error: the decimation should be positive."));
+
+    policy_ = policy;
+}
+
+
+bool ProbeThrottle::accept()
+{
+    const std::uint64_t index = number_received_++;
+
+    if ((index % policy_.decimation) != 0)
+    {
+        number_dropped_++;
+        return false;
+    }
+
+    if (policy_.maximum_rate > 0)
+    {
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+        if (valid_last_time_ && (std::chrono::duration<double>(now - last_time_).count() < 1.0 / policy_.maximum_rate))
+        {
+            number_dropped_++;
+            return false;
+        }
+
+        last_time_ = now;
+        valid_last_time_ = true;
+    }
+
+    return true;
+}
+
+
+std::uint64_t ProbeThrottle::number_dropped() const
+{
+    return number_dropped_;
+}
@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#include <RobotsIO/Utils/SharedMemoryImageProbe.h>
+
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+using namespace RobotsIO::Utils;
+
+
+SharedMemoryImageProbe::SharedMemoryImageProbe(const std::string& name, const std::size_t& slot_size, const std::size_t& number_slots) :
+    ring_(name, number_slots, slot_size)
+{}
+
+
+SharedMemoryImageProbe::~SharedMemoryImageProbe()
+{}
+
+
+void SharedMemoryImageProbe::on_new_typed_data(const cv::Mat& data)
+{
+    const double timestamp = std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+    const std::array<std::int32_t, 4> description = {{static_cast<std::int32_t>(SharedMemoryRing::Content::Image), data.rows, data.cols, data.type()}};
+
+    const std::size_t row_size = data.cols * data.elemSize();
+    const char* image = reinterpret_cast<const char*>(data.data);
+
+    if (!data.isContinuous())
+    {
+        /* Padding is removed. */
+        buffer_.resize(data.rows * row_size);
+        for (int i = 0; i < data.rows; i++)
+            std::memcpy(buffer_.data() + i * row_size, data.ptr(i), row_size);
+        image = buffer_.data();
+    }
+
+    if (!ring_.write(timestamp, description, image, data.rows * row_size))
+        throw(std::runtime_error(log_name_ + "::on_new_typed_data. Error: the image exceeds the size of the slots."));
+}
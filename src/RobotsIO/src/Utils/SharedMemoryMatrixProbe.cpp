@@ -0,0 +1,33 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#include <RobotsIO/Utils/SharedMemoryMatrixProbe.h>
+
+#include <chrono>
+#include <stdexcept>
+
+using namespace RobotsIO::Utils;
+
+
+SharedMemoryMatrixProbe::SharedMemoryMatrixProbe(const std::string& name, const std::size_t& slot_size, const std::size_t& number_slots) :
+    ring_(name, number_slots, slot_size * sizeof(double))
+{}
+
+
+SharedMemoryMatrixProbe::~SharedMemoryMatrixProbe()
+{}
+
+
+void SharedMemoryMatrixProbe::on_new_typed_data(const Eigen::MatrixXd& data)
+{
+    const double timestamp = std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+    const std::array<std::int32_t, 4> description = {{static_cast<std::int32_t>(SharedMemoryRing::Content::Matrix), static_cast<std::int32_t>(data.rows()), static_cast<std::int32_t>(data.cols()), 0}};
+
+    if (!ring_.write(timestamp, description, reinterpret_cast<const char*>(data.data()), data.size() * sizeof(double)))
+        throw(std::runtime_error(log_name_ + "::on_new_typed_data. Error: the matrix exceeds the size of the slots."));
+}
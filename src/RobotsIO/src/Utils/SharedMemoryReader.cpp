@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#include <RobotsIO/Utils/SharedMemoryReader.h>
+
+#include <cstring>
+#include <tuple>
+
+using namespace Eigen;
+using namespace RobotsIO::Utils;
+
+
+SharedMemoryReader::SharedMemoryReader(const std::string& name) :
+    ring_(name)
+{}
+
+
+SharedMemoryReader::~SharedMemoryReader()
+{}
+
+
+bool SharedMemoryReader::read_image(cv::Mat& image, double& timestamp, const double& timeout)
+{
+    while (true)
+    {
+        bool valid_view = false;
+        SharedMemoryRing::View view;
+        std::tie(valid_view, view) = wait_view(timeout);
+        if (!valid_view)
+            return false;
+
+        if (view.description[0] != static_cast<std::int32_t>(SharedMemoryRing::Content::Image))
+            return false;
+
+        image.create(view.description[1], view.description[2], view.description[3]);
+        if (image.total() * image.elemSize() != view.size)
+        {
+            if (ring_.is_valid(view))
+                return false;
+            continue;
+        }
+        std::memcpy(image.data, view.data, view.size);
+
+        /* Retry if the slot has been overwritten while copying. */
+        if (ring_.is_valid(view))
+        {
+            sequence_ = view.sequence;
+            timestamp = view.timestamp;
+
+            return true;
+        }
+    }
+}
+
+
+bool SharedMemoryReader::read_matrix(MatrixXd& matrix, double& timestamp, const double& timeout)
+{
+    while (true)
+    {
+        bool valid_view = false;
+        SharedMemoryRing::View view;
+        std::tie(valid_view, view) = wait_view(timeout);
+        if (!valid_view)
+            return false;
+
+        if (view.description[0] != static_cast<std::int32_t>(SharedMemoryRing::Content::Matrix))
+            return false;
+
+        matrix.resize(view.description[1], view.description[2]);
+        if (matrix.size() * sizeof(double) != view.size)
+        {
+            if (ring_.is_valid(view))
+                return false;
+            continue;
+        }
+        std::memcpy(matrix.data(), view.data, view.size);
+
+        /* Retry if the slot has been overwritten while copying. */
+        if (ring_.is_valid(view))
+        {
+            sequence_ = view.sequence;
+            timestamp = view.timestamp;
+
+            return true;
+        }
+    }
+}
+
+
+const SharedMemoryRing& SharedMemoryReader::ring() const
+{
+    return ring_;
+}
+
+
+std::pair<bool, SharedMemoryRing::View> SharedMemoryReader::wait_view(const double& timeout)
+{
+    if (!ring_.wait_newer(sequence_, timeout))
+        return std::make_pair(false, SharedMemoryRing::View());
+
+    return ring_.view_latest();
+}
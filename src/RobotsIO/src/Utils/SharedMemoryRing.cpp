@@ -0,0 +1,326 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#include <RobotsIO/Utils/SharedMemoryRing.h>
+
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+using namespace RobotsIO::Utils;
+
+
+namespace
+{
+    const std::uint32_t ring_magic = 0x52494f52;
+
+    const std::uint32_t ring_version = 1;
+
+    const std::size_t cache_line = 64;
+
+    std::size_t round_to_cache_line(const std::size_t& size)
+    {
+        return ((size + cache_line - 1) / cache_line) * cache_line;
+    }
+}
+
+
+struct SharedMemoryRing::Header
+{
+    std::uint32_t magic;
+
+    std::uint32_t version;
+
+    std::uint64_t number_slots;
+
+    std::uint64_t slot_size;
+
+    std::atomic<std::uint64_t> sequence;
+
+    /* Incremented at each write, readers wait on it. */
+    std::atomic<std::uint32_t> futex;
+};
+
+
+struct SharedMemoryRing::Slot
+{
+    /* Odd while the slot is being written. */
+    std::atomic<std::uint64_t> lock;
+
+    std::uint64_t sequence;
+
+    std::uint64_t size;
+
+    double timestamp;
+
+    std::int32_t description[4];
+};
+
+
+SharedMemoryRing::SharedMemoryRing(const std::string& name, const std::size_t& number_slots, const std::size_t& slot_size) :
+    name_(name),
+    owner_(true),
+    number_slots_(number_slots),
+    slot_size_(slot_size)
+{
+    if (number_slots == 0)
+        throw(std::runtime_error(log_name_ + "::ctor. Error: the number of slots should be positive."));
+
+    slot_stride_ = round_to_cache_line(sizeof(Slot)) + round_to_cache_line(slot_size);
+    memory_size_ = round_to_cache_line(sizeof(Header)) + number_slots * slot_stride_;
+
+    /* An existing ring is unlinked rather than truncated, as it might still be mapped by readers,
+       and the new one is created exclusively, such that it is never shared with another writer. */
+    shm_unlink(name_.c_str());
+    descriptor_ = shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (descriptor_ < 0)
+        throw(std::runtime_error(log_name_ + "::ctor. Error: cannot create shared memory " + name_ + " (" + std::strerror(errno) + ")."));
+
+    if (ftruncate(descriptor_, memory_size_) != 0)
+    {
+        close(descriptor_);
+        shm_unlink(name_.c_str());
+        throw(std::runtime_error(log_name_ + "::ctor. Error: cannot resize shared memory " + name_ + " (" + std::strerror(errno) + ")."));
+    }
+
+    memory_ = mmap(nullptr, memory_size_, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor_, 0);
+    if (memory_ == MAP_FAILED)
+    {
+        close(descriptor_);
+        shm_unlink(name_.c_str());
+        throw(std::runtime_error(log_name_ + "::ctor. Error: cannot map shared memory " + name_ + " (" + std::strerror(errno) + ")."));
+    }
+
+    /* Memory of a new shared memory object is zero-initialized. */
+    header_ = new (memory_) Header;
+    header_->number_slots = number_slots;
+    header_->slot_size = slot_size;
+    header_->sequence.store(0);
+    header_->futex.store(0);
+    for (std::size_t i = 0; i < number_slots; i++)
+        new (slot(i)) Slot;
+    header_->version = ring_version;
+
+    /* Readers check the magic number last. */
+    std::atomic_thread_fence(std::memory_order_release);
+    header_->magic = ring_magic;
+}
+
+
+SharedMemoryRing::SharedMemoryRing(const std::string& name) :
+    name_(name),
+    owner_(false)
+{
+    descriptor_ = shm_open(name_.c_str(), O_RDONLY, 0);
+    if (descriptor_ < 0)
+        throw(std::runtime_error(log_name_ + "::ctor. Error: cannot open shared memory " + name_ + " (" + std::strerror(errno) + ")."));
+
+    struct stat status;
+    if ((fstat(descriptor_, &status) != 0) || (static_cast<std::size_t>(status.st_size) < sizeof(Header)))
+    {
+        close(descriptor_);
+        throw(std::runtime_error(log_name_ + "::ctor. Error: shared memory " + name_ + " is not a valid ring."));
+    }
+    memory_size_ = status.st_size;
+
+    memory_ = mmap(nullptr, memory_size_, PROT_READ, MAP_SHARED, descriptor_, 0);
+    if (memory_ == MAP_FAILED)
+    {
+        close(descriptor_);
+        throw(std::runtime_error(log_name_ + "::ctor. Error: cannot map shared memory " + name_ + " (" + std::strerror(errno) + ")."));
+    }
+
+    header_ = static_cast<Header*>(memory_);
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    /* The geometry is validated against the size of the mapping once, and then only compared with the header. */
+    number_slots_ = header_->number_slots;
+    slot_size_ = header_->slot_size;
+    slot_stride_ = round_to_cache_line(sizeof(Slot)) + round_to_cache_line(slot_size_);
+    if ((header_->magic != ring_magic) || (header_->version != ring_version) || (number_slots_ == 0) ||
+        (slot_size_ > memory_size_) || ((memory_size_ - round_to_cache_line(sizeof(Header))) / slot_stride_ < number_slots_))
+    {
+        munmap(memory_, memory_size_);
+        close(descriptor_);
+        throw(std::runtime_error(log_name_ + "::ctor. Error: shared memory " + name_ + " is not a valid ring."));
+    }
+}
+
+
+SharedMemoryRing::~SharedMemoryRing()
+{
+    /* The name is unlinked only if it still refers to this ring, rather than to the one of a newer writer. */
+    if (owner_)
+    {
+        struct stat status;
+        struct stat current_status;
+
+        const int current_descriptor = shm_open(name_.c_str(), O_RDONLY, 0);
+        if (current_descriptor >= 0)
+        {
+            if ((fstat(descriptor_, &status) == 0) && (fstat(current_descriptor, &current_status) == 0) &&
+                (status.st_dev == current_status.st_dev) && (status.st_ino == current_status.st_ino))
+                shm_unlink(name_.c_str());
+
+            close(current_descriptor);
+        }
+    }
+
+    munmap(memory_, memory_size_);
+    close(descriptor_);
+}
+
+
+std::size_t SharedMemoryRing::slot_size() const
+{
+    return slot_size_;
+}
+
+
+bool SharedMemoryRing::write(const double& timestamp, const std::array<std::int32_t, 4>& description, const char* data, const std::size_t& size)
+{
+    if (size > slot_size_)
+        return false;
+
+    const std::uint64_t sequence = header_->sequence.load(std::memory_order_relaxed) + 1;
+    Slot* destination = slot(sequence % number_slots_);
+
+    const std::uint64_t lock = destination->lock.load(std::memory_order_relaxed);
+    destination->lock.store(lock + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    destination->sequence = sequence;
+    destination->size = size;
+    destination->timestamp = timestamp;
+    std::memcpy(destination->description, description.data(), sizeof(destination->description));
+    std::memcpy(reinterpret_cast<char*>(destination) + round_to_cache_line(sizeof(Slot)), data, size);
+
+    destination->lock.store(lock + 2, std::memory_order_release);
+    header_->sequence.store(sequence, std::memory_order_release);
+
+    header_->futex.fetch_add(1, std::memory_order_release);
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&header_->futex), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+
+    return true;
+}
+
+
+std::uint64_t SharedMemoryRing::latest_sequence() const
+{
+    if (!is_consistent())
+        return 0;
+
+    return header_->sequence.load(std::memory_order_acquire);
+}
+
+
+bool SharedMemoryRing::wait_newer(const std::uint64_t& sequence, const double& timeout) const
+{
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    if (timeout >= 0)
+    {
+        double seconds = deadline.tv_sec + deadline.tv_nsec * 1e-9 + timeout;
+        deadline.tv_sec = static_cast<time_t>(std::floor(seconds));
+        deadline.tv_nsec = static_cast<long>((seconds - std::floor(seconds)) * 1e9);
+    }
+
+    while (true)
+    {
+        /* The value of the futex is read before checking the condition, such that wake ups are not lost. */
+        const std::uint32_t futex = header_->futex.load(std::memory_order_acquire);
+        if (!is_consistent())
+            return false;
+
+        if (latest_sequence() > sequence)
+            return true;
+
+        struct timespec remaining;
+        struct timespec* remaining_pointer = nullptr;
+        if (timeout >= 0)
+        {
+            struct timespec now;
+            clock_gettime(CLOCK_MONOTONIC, &now);
+
+            double seconds = (deadline.tv_sec - now.tv_sec) + (deadline.tv_nsec - now.tv_nsec) * 1e-9;
+            if (seconds <= 0)
+                return false;
+
+            remaining.tv_sec = static_cast<time_t>(std::floor(seconds));
+            remaining.tv_nsec = static_cast<long>((seconds - std::floor(seconds)) * 1e9);
+            remaining_pointer = &remaining;
+        }
+
+        syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&header_->futex), FUTEX_WAIT, futex, remaining_pointer, nullptr, 0);
+    }
+}
+
+
+std::pair<bool, SharedMemoryRing::View> SharedMemoryRing::view_latest() const
+{
+    View view;
+
+    while (true)
+    {
+        const std::uint64_t sequence = latest_sequence();
+        if (sequence == 0)
+            return std::make_pair(false, View());
+
+        const Slot* source = slot(sequence % number_slots_);
+
+        view.lock = source->lock.load(std::memory_order_acquire);
+        if (view.lock % 2 == 1)
+            continue;
+
+        view.sequence = source->sequence;
+        view.size = source->size;
+        view.timestamp = source->timestamp;
+        std::memcpy(view.description.data(), source->description, sizeof(source->description));
+        view.data = reinterpret_cast<const char*>(source) + round_to_cache_line(sizeof(Slot));
+
+        /* A slot only holds sequence numbers mapped to it, unless it was being overwritten. */
+        if ((view.sequence % number_slots_ == sequence % number_slots_) && (view.size <= slot_size_) && is_valid(view))
+            return std::make_pair(true, view);
+    }
+}
+
+
+bool SharedMemoryRing::is_valid(const View& view) const
+{
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    if (!is_consistent())
+        return false;
+
+    const Slot* source = slot(view.sequence % number_slots_);
+
+    return source->lock.load(std::memory_order_relaxed) == view.lock;
+}
+
+
+SharedMemoryRing::Slot* SharedMemoryRing::slot(const std::size_t& index) const
+{
+    return reinterpret_cast<Slot*>(static_cast<char*>(memory_) + round_to_cache_line(sizeof(Header)) + index * slot_stride_);
+}
+
+
+bool SharedMemoryRing::is_consistent() const
+{
+    return (header_->magic == ring_magic) && (header_->number_slots == number_slots_) && (header_->slot_size == slot_size_);
+}
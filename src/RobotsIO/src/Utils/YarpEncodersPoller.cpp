@@ -0,0 +1,207 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#include <RobotsIO/Utils/YarpEncodersPoller.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <yarp/eigen/Eigen.h>
+
+using namespace Eigen;
+using namespace RobotsIO::Utils;
+
+
+YarpEncodersPoller::YarpEncodersPoller
+(
+    const std::vector<yarp::dev::IEncodersTimed*>& encoders,
+    const double& period,
+    const std::size_t& history_size
+) :
+    yarp::os::PeriodicThread(period),
+    encoders_(encoders),
+    history_size_(history_size),
+    written_(0)
+{
+    if (history_size_ < 2)
+        throw(std::runtime_error(log_name_ + "::ctor. Error: the history should contain at least two samples."));
+
+    /* Allocate storage for the readings. */
+    for (auto interface : encoders_)
+    {
+        int axes = 0;
+        if ((interface == nullptr) || (!interface->getAxes(&axes)))
+            throw(std::runtime_error(log_name_ + "::ctor. Error: cannot retrieve the number of axes of the encoders."));
+
+        readings_.emplace_back(axes);
+        timestamps_.emplace_back(axes);
+        number_of_joints_ += axes;
+    }
+
+    /* Allocate the ring buffer. */
+    slots_ = std::unique_ptr<Slot[]>(new Slot[history_size_]);
+    for (std::size_t i = 0; i < history_size_; i++)
+    {
+        slots_[i].sequence = 0;
+        slots_[i].sample = 0;
+        slots_[i].timestamp = 0.0;
+        slots_[i].joints = std::unique_ptr<std::atomic<double>[]>(new std::atomic<double>[number_of_joints_]);
+    }
+}
+
+
+YarpEncodersPoller::~YarpEncodersPoller()
+{
+    if (isRunning())
+        stop();
+}
+
+
+std::pair<bool, VectorXd> YarpEncodersPoller::encoders_at(const double& timestamp) const
+{
+    VectorXd joints;
+    if (!encoders_at(timestamp, joints))
+        return std::make_pair(false, VectorXd());
+
+    return std::make_pair(true, std::move(joints));
+}
+
+
+std::tuple<bool, double, VectorXd> YarpEncodersPoller::latest_encoders() const
+{
+    double timestamp;
+    VectorXd joints;
+    if (!latest_encoders(timestamp, joints))
+        return std::make_tuple(false, 0.0, VectorXd());
+
+    return std::make_tuple(true, timestamp, std::move(joints));
+}
+
+
+bool YarpEncodersPoller::encoders_at(const double& timestamp, VectorXd& joints) const
+{
+    const std::uint64_t written = written_.load(std::memory_order_acquire);
+    if (written == 0)
+        return false;
+
+    const std::uint64_t oldest = (written > history_size_) ? (written - history_size_) : 0;
+
+    /* Storage of the newer sample, allocated once per thread as the poller supports concurrent readers. */
+    thread_local VectorXd joints_after;
+    joints_after.resize(number_of_joints_);
+    joints.resize(number_of_joints_);
+
+    /* Walk the history backwards, starting from the newest sample, until a sample not newer than the request is found. */
+    double timestamp_after = 0.0;
+    double timestamp_before;
+    for (std::uint64_t sample = written; sample-- > oldest;)
+    {
+        /* Samples being overwritten in the meantime are too old to be used. */
+        if (!read_sample(sample, timestamp_before, joints))
+            return false;
+
+        if (timestamp_before <= timestamp)
+        {
+            /* The request is newer than the newest sample. */
+            if (sample == (written - 1))
+                return true;
+
+            const double span = timestamp_after - timestamp_before;
+            if (span <= 0.0)
+            {
+                joints.swap(joints_after);
+                return true;
+            }
+
+            const double alpha = (timestamp - timestamp_before) / span;
+            joints += alpha * (joints_after - joints);
+
+            return true;
+        }
+
+        /* Swapping exchanges the storage of the two vectors, hence it does not allocate. */
+        timestamp_after = timestamp_before;
+        joints_after.swap(joints);
+    }
+
+    return false;
+}
+
+
+bool YarpEncodersPoller::latest_encoders(double& timestamp, VectorXd& joints) const
+{
+    const std::uint64_t written = written_.load(std::memory_order_acquire);
+    if (written == 0)
+        return false;
+
+    joints.resize(number_of_joints_);
+
+    return read_sample(written - 1, timestamp, joints);
+}
+
+
+std::size_t YarpEncodersPoller::number_of_joints() const
+{
+    return number_of_joints_;
+}
+
+
+void YarpEncodersPoller::run()
+{
+    /* Read all the interfaces. */
+    double timestamp = 0.0;
+    for (std::size_t i = 0; i < encoders_.size(); i++)
+    {
+        if (!encoders_[i]->getEncodersTimed(readings_[i].data(), timestamps_[i].data()))
+            return;
+
+        timestamp = std::max(timestamp, yarp::eigen::toEigen(timestamps_[i]).maxCoeff());
+    }
+
+    /* Store the sample. */
+    const std::uint64_t sample = written_.load(std::memory_order_relaxed);
+    Slot& slot = slots_[sample % history_size_];
+
+    const std::uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+    slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.sample.store(sample, std::memory_order_relaxed);
+    slot.timestamp.store(timestamp, std::memory_order_relaxed);
+    std::size_t j = 0;
+    for (const auto& reading : readings_)
+        for (std::size_t k = 0; k < reading.size(); k++)
+            slot.joints[j++].store(reading[k], std::memory_order_relaxed);
+
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+
+    written_.store(sample + 1, std::memory_order_release);
+}
+
+
+bool YarpEncodersPoller::read_sample(const std::uint64_t& sample, double& timestamp, Ref<VectorXd> joints) const
+{
+    const Slot& slot = slots_[sample % history_size_];
+
+    while (true)
+    {
+        const std::uint64_t sequence_begin = slot.sequence.load(std::memory_order_acquire);
+        if (sequence_begin % 2 == 1)
+            continue;
+
+        const std::uint64_t stored_sample = slot.sample.load(std::memory_order_relaxed);
+        timestamp = slot.timestamp.load(std::memory_order_relaxed);
+        for (std::size_t j = 0; j < number_of_joints_; j++)
+            joints(j) = slot.joints[j].load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != sequence_begin)
+            continue;
+
+        return (stored_sample == sample);
+    }
+}
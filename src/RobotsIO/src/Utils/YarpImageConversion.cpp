@@ -0,0 +1,41 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#include <RobotsIO/Utils/YarpImageConversion.h>
+
+using namespace Eigen;
+using namespace yarp::sig;
+
+
+void RobotsIO::Utils::yarp_image_to_bgr(const ImageOf<PixelRgb>& image, cv::Mat& output)
+{
+    /* The header is only read from, while rows may be padded. */
+    const cv::Mat input(image.height(), image.width(), CV_8UC3, image.getRawImage(), image.getRowSize());
+
+    cv::cvtColor(input, output, cv::COLOR_RGB2BGR);
+}
+
+
+void RobotsIO::Utils::yarp_image_to_depth(const ImageOf<PixelFloat>& image, MatrixXf& output)
+{
+    /* Rows may be padded. */
+    Eigen::Map<const Eigen::Matrix<float, Dynamic, Dynamic, RowMajor>, 0, OuterStride<>> input
+    (
+        reinterpret_cast<const float*>(image.getRawImage()),
+        image.height(),
+        image.width(),
+        OuterStride<>(image.getRowSize() / sizeof(float))
+    );
+
+    output = input;
+}
+
+
+bool RobotsIO::Utils::is_mat_shared(const cv::Mat& image)
+{
+    return (image.u != nullptr) && (image.u->refcount > 1);
+}
@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#include <RobotsIO/Utils/YarpPoseStream.h>
+
+#include <yarp/eigen/Eigen.h>
+#include <yarp/os/Stamp.h>
+#include <yarp/os/Time.h>
+
+using namespace Eigen;
+using namespace RobotsIO::Utils;
+using namespace yarp::eigen;
+using namespace yarp::os;
+using namespace yarp::sig;
+
+
+YarpPoseStream::YarpPoseStream(const std::string& port_name, const std::size_t& history_size)
+{
+    /* Check YARP network. */
+    if (!yarp_.checkNetwork())
+    {
+        throw(std::runtime_error(log_name_ + "::ctor. Error: YARP network is not available."));
+    }
+
+    if (history_size < 2)
+    {
+        throw(std::runtime_error(log_name_ + "::ctor. Error: the history should contain at least two poses."));
+    }
+
+    history_.resize(history_size);
+
+    /* Open pose input port. */
+    if (!(port_.open(port_name)))
+    {
+        std::string err = log_name_ + "::ctor. Error: cannot open pose input port " + port_name + ".";
+        throw(std::runtime_error(err));
+    }
+
+    port_.useCallback(*this);
+}
+
+
+YarpPoseStream::~YarpPoseStream()
+{
+    port_.disableCallback();
+
+    port_.close();
+}
+
+
+void YarpPoseStream::onRead(VectorOf<double>& data)
+{
+    if (data.size() != 7)
+        return;
+
+    Stamp stamp;
+    const double timestamp = (port_.getEnvelope(stamp) && stamp.isValid()) ? stamp.getTime() : Time::now();
+
+    StampedPose pose;
+    pose.timestamp = timestamp;
+    pose.position = toEigen(data).head<3>();
+
+    const Vector3d axis = toEigen(data).segment<3>(3);
+    if (axis.norm() > 0)
+        pose.orientation = Quaterniond(AngleAxisd(data[6], axis.normalized()));
+    else
+        pose.orientation = Quaterniond::Identity();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    /* Poses are expected in chronological order. */
+    if ((count_ > 0) && (timestamp < at(count_ - 1).timestamp))
+        return;
+
+    if (count_ == history_.size())
+    {
+        /* Overwrite the oldest pose. */
+        head_ = (head_ + 1) % history_.size();
+        count_--;
+    }
+
+    history_[(head_ + count_) % history_.size()] = pose;
+    count_++;
+}
+
+
+std::pair<bool, Transform<double, 3, Affine>> YarpPoseStream::pose_at(const double& timestamp) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if ((count_ == 0) || (timestamp < at(0).timestamp))
+        return std::make_pair(false, Transform<double, 3, Affine>());
+
+    const StampedPose& newest = at(count_ - 1);
+    if (timestamp >= newest.timestamp)
+        return std::make_pair(true, to_transform(newest.position, newest.orientation));
+
+    /* Binary search of the first pose newer than the timestamp, within a history of fixed size. */
+    std::size_t lower = 0;
+    std::size_t upper = count_ - 1;
+    while (upper - lower > 1)
+    {
+        const std::size_t middle = (lower + upper) / 2;
+        if (at(middle).timestamp <= timestamp)
+            lower = middle;
+        else
+            upper = middle;
+    }
+
+    const StampedPose& before = at(lower);
+    const StampedPose& after = at(upper);
+    const double interval = after.timestamp - before.timestamp;
+    const double t = interval > 0 ? (timestamp - before.timestamp) / interval : 0.0;
+
+    const Vector3d position = (1.0 - t) * before.position + t * after.position;
+    const Quaterniond orientation = before.orientation.slerp(t, after.orientation);
+
+    return std::make_pair(true, to_transform(position, orientation));
+}
+
+
+std::pair<bool, Transform<double, 3, Affine>> YarpPoseStream::latest_pose() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (count_ == 0)
+        return std::make_pair(false, Transform<double, 3, Affine>());
+
+    const StampedPose& newest = at(count_ - 1);
+
+    return std::make_pair(true, to_transform(newest.position, newest.orientation));
+}
+
+
+const YarpPoseStream::StampedPose& YarpPoseStream::at(const std::size_t& index) const
+{
+    /* Index 0 is the oldest pose. */
+    return history_[(head_ + index) % history_.size()];
+}
+
+
+Transform<double, 3, Affine> YarpPoseStream::to_transform(const Vector3d& position, const Quaterniond& orientation) const
+{
+    Transform<double, 3, Affine> pose;
+    pose = Translation<double, 3>(position);
+    pose.rotate(orientation);
+
+    return pose;
+}
@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#include <RobotsIO/Utils/YarpVectorOfBatch.h>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+using namespace Eigen;
+using namespace yarp::sig;
+
+
+bool RobotsIO::Utils::unpack_vector_of_batch(const VectorOf<double>& batch, VectorXd& timestamps, MatrixXd& samples)
+{
+    if (batch.size() < 2)
+        return false;
+
+    /* The header is validated before being converted, as converting values not representable by std::size_t is undefined. */
+    for (std::size_t i = 0; i < 2; i++)
+    {
+        if (!std::isfinite(batch[i]) || (batch[i] < 0) || (batch[i] > std::numeric_limits<std::uint32_t>::max()) || (std::floor(batch[i]) != batch[i]))
+            return false;
+    }
+
+    const std::size_t number_samples = static_cast<std::size_t>(batch[0]);
+    const std::size_t sample_size = static_cast<std::size_t>(batch[1]);
+
+    /* The size of the payload is checked by dividing, such that the check cannot overflow. */
+    const std::size_t payload_size = batch.size() - 2;
+    if (number_samples == 0)
+    {
+        if (payload_size != 0)
+            return false;
+    }
+    else
+    {
+        const std::size_t record_size = payload_size / number_samples;
+        if ((payload_size % number_samples != 0) || (record_size == 0) || (record_size - 1 != sample_size))
+            return false;
+    }
+
+    /* Each column holds the timestamp followed by the sample. */
+    Eigen::Map<const MatrixXd> records(batch.data() + 2, sample_size + 1, number_samples);
+
+    timestamps = records.row(0).transpose();
+    samples = records.bottomRows(sample_size);
+
+    return true;
+}
@@ -10,26 +10,15 @@
 using namespace RobotsIO::Utils;
 
 
-template <>
-yarp::sig::VectorOf<double> RobotsIO::Utils::YarpVectorOfProbe<double, Eigen::VectorXd>::convert_from(const Eigen::VectorXd& data)
+void YarpVectorOfConversion<double, Eigen::Transform<double, 3, Eigen::Affine>>::convert(const Eigen::Transform<double, 3, Eigen::Affine>& data, yarp::sig::VectorOf<double>& output)
 {
-    yarp::sig::VectorOf<double> tmp(data.size());
-    yarp::eigen::toEigen(tmp) = data;
-
-    return tmp;
-}
+    if (output.size() != 7)
+        output.resize(7);
 
-
-template <>
-yarp::sig::VectorOf<double> RobotsIO::Utils::YarpVectorOfProbe<double, Eigen::Transform<double, 3, Eigen::Affine>>::convert_from(const Eigen::Transform<double, 3, Eigen::Affine>& data)
-{
-    /* Assume by default transformation to x-y-z-axis-angle. */
-    yarp::sig::VectorOf<double> tmp(7);
-    yarp::eigen::toEigen(tmp).head<3>() = data.translation();
+    Eigen::Map<Eigen::VectorXd> output_eigen(output.data(), 7);
+    output_eigen.head<3>() = data.translation();
 
     Eigen::AngleAxisd axis_angle(data.rotation());
-    yarp::eigen::toEigen(tmp).segment<3>(3) = axis_angle.axis();
-    yarp::eigen::toEigen(tmp)(6) = axis_angle.angle();
-
-    return tmp;
+    output_eigen.segment<3>(3) = axis_angle.axis();
+    output_eigen(6) = axis_angle.angle();
 }
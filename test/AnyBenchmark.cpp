@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#include <RobotsIO/Utils/any.h>
+
+#include <Eigen/Dense>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+using namespace Eigen;
+
+/**
+ * Compares RobotsIO::Utils::any against the previous implementation, which allocated every contained object dynamically,
+ * when constructing, copying and assigning typical probe data.
+ */
+
+namespace
+{
+    /* The previous implementation, reduced to what is benchmarked. */
+    class HeapAny
+    {
+    public:
+        HeapAny() : content(nullptr) { }
+
+        template<class T>
+        HeapAny(const T& value) : content(new holder<T>(value)) { }
+
+        HeapAny(const HeapAny& other) : content(other.content ? other.content->clone() : nullptr) { }
+
+        ~HeapAny() { delete content; }
+
+        HeapAny& operator=(const HeapAny& rhs)
+        {
+            HeapAny(rhs).swap(*this);
+            return *this;
+        }
+
+        void swap(HeapAny& rhs) { std::swap(content, rhs.content); }
+
+        template<class T>
+        T* cast() { return content && content->type() == typeid(T) ? &static_cast<holder<T>*>(content)->held : nullptr; }
+
+    private:
+        struct placeholder
+        {
+            virtual ~placeholder() { }
+
+            virtual const std::type_info& type() const = 0;
+
+            virtual placeholder* clone() const = 0;
+        };
+
+        template<class T>
+        struct holder : placeholder
+        {
+            holder(const T& value) : held(value) { }
+
+            const std::type_info& type() const override { return typeid(T); }
+
+            placeholder* clone() const override { return new holder(held); }
+
+            T held;
+        };
+
+        placeholder* content;
+    };
+
+
+    template<class Any, class T>
+    T* cast(Any& value);
+
+    template<>
+    double* cast(RobotsIO::Utils::any& value) { return RobotsIO::Utils::any_cast<double>(&value); }
+
+    template<>
+    double* cast(HeapAny& value) { return value.cast<double>(); }
+
+    template<>
+    Transform<double, 3, Affine>* cast(RobotsIO::Utils::any& value) { return RobotsIO::Utils::any_cast<Transform<double, 3, Affine>>(&value); }
+
+    template<>
+    Transform<double, 3, Affine>* cast(HeapAny& value) { return value.cast<Transform<double, 3, Affine>>(); }
+
+    template<>
+    VectorXd* cast(RobotsIO::Utils::any& value) { return RobotsIO::Utils::any_cast<VectorXd>(&value); }
+
+    template<>
+    VectorXd* cast(HeapAny& value) { return value.cast<VectorXd>(); }
+
+
+    double first_value(const double& value) { return value; }
+
+    double first_value(const Transform<double, 3, Affine>& value) { return value.matrix()(0, 0); }
+
+    double first_value(const VectorXd& value) { return value(0); }
+
+
+    /* Nanoseconds per iteration of constructing from a value, assigning it to a long-lived object and reading it back. */
+    template<class Any, class T>
+    double benchmark(const T& sample, const std::size_t& iterations)
+    {
+        Any stored;
+        double sum = 0.0;
+
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < iterations; i++)
+        {
+            const Any value(sample);
+            stored = value;
+            sum += first_value(*cast<Any, T>(stored));
+        }
+        const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+        /* Keeps the loop observable. */
+        if (sum != iterations * first_value(sample))
+            std::exit(EXIT_FAILURE);
+
+        return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+    }
+
+
+    /* The implementations are alternated and the fastest of several runs is kept, reducing the effect of other processes. */
+    template<class T>
+    void compare(const std::string& name, const T& sample, const std::size_t& iterations)
+    {
+        double previous = std::numeric_limits<double>::infinity();
+        double current = std::numeric_limits<double>::infinity();
+
+        for (std::size_t i = 0; i < 5; i++)
+        {
+            previous = std::min(previous, benchmark<HeapAny>(sample, iterations));
+            current = std::min(current, benchmark<RobotsIO::Utils::any>(sample, iterations));
+        }
+
+        std::cout << name << "\t" << previous << "\t" << current << std::endl;
+    }
+}
+
+
+int main()
+{
+    const std::size_t iterations = 200000;
+
+    std::cout << "sizeof(any) = " << sizeof(RobotsIO::Utils::any) << " bytes, previously " << sizeof(HeapAny) << " bytes" << std::endl;
+    std::cout << "data\tprevious [ns]\tcurrent [ns]" << std::endl;
+
+    compare("double", 1.0, iterations);
+
+    Transform<double, 3, Affine> transform = Transform<double, 3, Affine>::Identity();
+    compare("Transform3d", transform, iterations);
+
+    compare("VectorXd(6)", VectorXd::Ones(6).eval(), iterations);
+
+    compare("VectorXd(1024)", VectorXd::Ones(1024).eval(), iterations / 10);
+
+    compare("VectorXd(307200)", VectorXd::Ones(640 * 480).eval(), iterations / 1000);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,231 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#include <Check.h>
+
+#include <RobotsIO/Utils/any.h>
+
+#include <Eigen/Dense>
+
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace RobotsIO::Utils;
+
+namespace
+{
+    /* Counts the live instances, such that leaks and double destructions are detected. */
+    struct Counted
+    {
+        static int instances;
+
+        int value;
+
+        Counted(const int& value) : value(value) { instances++; }
+
+        Counted(const Counted& other) : value(other.value) { instances++; }
+
+        Counted(Counted&& other) noexcept : value(other.value) { instances++; }
+
+        Counted& operator=(const Counted& other) { value = other.value; return *this; }
+
+        ~Counted() { instances--; }
+    };
+
+    int Counted::instances = 0;
+
+
+    /* Stored dynamically, as it cannot be moved without exceptions. */
+    struct ThrowingMove
+    {
+        int value;
+
+        ThrowingMove(const int& value) : value(value) { }
+
+        ThrowingMove(const ThrowingMove& other) : value(other.value) { }
+
+        ThrowingMove(ThrowingMove&& other) noexcept(false) : value(other.value) { }
+    };
+
+
+    /* Copying throws while armed. */
+    struct ThrowingCopy
+    {
+        static bool armed;
+
+        int value;
+
+        ThrowingCopy(const int& value) : value(value) { }
+
+        ThrowingCopy(const ThrowingCopy& other) : value(other.value) { if (armed) throw(std::runtime_error("copy")); }
+
+        ThrowingCopy(ThrowingCopy&& other) noexcept : value(other.value) { }
+
+        ThrowingCopy& operator=(const ThrowingCopy& other) { if (armed) throw(std::runtime_error("copy")); value = other.value; return *this; }
+    };
+
+    bool ThrowingCopy::armed = false;
+
+
+    /* Stored dynamically, as it does not fit the small buffer. */
+    struct Big
+    {
+        double values[64];
+    };
+}
+
+
+int main()
+{
+    /* Empty. */
+    {
+        any empty;
+        ROBOTSIO_CHECK(!empty.has_value());
+        ROBOTSIO_CHECK(empty.type() == typeid(void));
+        ROBOTSIO_CHECK(any_cast<int>(&empty) == nullptr);
+    }
+
+    /* Small, large and throwing-move contents, copied, moved and casted. */
+    {
+        any small(Counted(1));
+        any large(Big{{2.0}});
+        any throwing(ThrowingMove(3));
+
+        ROBOTSIO_CHECK(Counted::instances == 1);
+        ROBOTSIO_CHECK(any_cast<Counted&>(small).value == 1);
+        ROBOTSIO_CHECK(any_cast<Big&>(large).values[0] == 2.0);
+        ROBOTSIO_CHECK(any_cast<ThrowingMove&>(throwing).value == 3);
+
+        any small_copy(small);
+        any large_copy(large);
+        ROBOTSIO_CHECK(Counted::instances == 2);
+        ROBOTSIO_CHECK(any_cast<Counted>(&small_copy) != any_cast<Counted>(&small));
+        ROBOTSIO_CHECK(any_cast<Big>(&large_copy)->values[0] == 2.0);
+
+        any small_moved(std::move(small_copy));
+        any large_moved(std::move(large_copy));
+        ROBOTSIO_CHECK(!small_copy.has_value());
+        ROBOTSIO_CHECK(!large_copy.has_value());
+        ROBOTSIO_CHECK(Counted::instances == 2);
+        ROBOTSIO_CHECK(any_cast<Counted&>(small_moved).value == 1);
+        ROBOTSIO_CHECK(any_cast<Big&>(large_moved).values[0] == 2.0);
+
+        bool thrown = false;
+        try
+        {
+            any_cast<double>(small);
+        }
+        catch (const bad_any_cast&)
+        {
+            thrown = true;
+        }
+        ROBOTSIO_CHECK(thrown);
+    }
+    ROBOTSIO_CHECK(Counted::instances == 0);
+
+    /* Copy assignment between contents of the same type results in independent copies. */
+    {
+        any first(std::vector<double>(1000, 1.0));
+        any second(std::vector<double>(10, 2.0));
+
+        first = second;
+        any_cast<std::vector<double>&>(first)[0] = 3.0;
+
+        ROBOTSIO_CHECK(any_cast<std::vector<double>&>(first).size() == 10);
+        ROBOTSIO_CHECK(any_cast<std::vector<double>&>(second).size() == 10);
+        ROBOTSIO_CHECK(any_cast<std::vector<double>&>(second)[0] == 2.0);
+    }
+
+    /* Should copying throw, the assigned object is left unchanged, even if both contain the same type. */
+    {
+        any first(ThrowingCopy(1));
+        any second(ThrowingCopy(2));
+
+        bool thrown = false;
+        ThrowingCopy::armed = true;
+        try
+        {
+            first = second;
+        }
+        catch (const std::runtime_error&)
+        {
+            thrown = true;
+        }
+        ThrowingCopy::armed = false;
+
+        ROBOTSIO_CHECK(thrown);
+        ROBOTSIO_CHECK(any_cast<ThrowingCopy&>(first).value == 1);
+
+        first = second;
+        ROBOTSIO_CHECK(any_cast<ThrowingCopy&>(first).value == 2);
+    }
+
+    /* Copy and move assignment across types and storages. */
+    {
+        any value(Counted(4));
+        value = any(Big{{5.0}});
+        ROBOTSIO_CHECK(Counted::instances == 0);
+        ROBOTSIO_CHECK(any_cast<Big&>(value).values[0] == 5.0);
+
+        any other(Counted(6));
+        value = other;
+        ROBOTSIO_CHECK(Counted::instances == 2);
+        ROBOTSIO_CHECK(any_cast<Counted&>(value).value == 6);
+
+        value = std::string("seven");
+        ROBOTSIO_CHECK(Counted::instances == 1);
+        ROBOTSIO_CHECK(any_cast<std::string&>(value) == "seven");
+
+        value = std::move(other);
+        ROBOTSIO_CHECK(Counted::instances == 1);
+        ROBOTSIO_CHECK(!other.has_value());
+        ROBOTSIO_CHECK(any_cast<Counted&>(value).value == 6);
+
+        value = value;
+        ROBOTSIO_CHECK(any_cast<Counted&>(value).value == 6);
+
+        value.reset();
+        ROBOTSIO_CHECK(!value.has_value());
+    }
+    ROBOTSIO_CHECK(Counted::instances == 0);
+
+    /* Swap between small and large contents. */
+    {
+        any small(Counted(8));
+        any large(Big{{9.0}});
+
+        small.swap(large);
+        ROBOTSIO_CHECK(any_cast<Big&>(small).values[0] == 9.0);
+        ROBOTSIO_CHECK(any_cast<Counted&>(large).value == 8);
+
+        swap(small, large);
+        ROBOTSIO_CHECK(any_cast<Counted&>(small).value == 8);
+        ROBOTSIO_CHECK(any_cast<Big&>(large).values[0] == 9.0);
+        ROBOTSIO_CHECK(Counted::instances == 1);
+    }
+    ROBOTSIO_CHECK(Counted::instances == 0);
+
+    /* Emplace and fixed-size Eigen types. */
+    {
+        any value;
+
+        Eigen::Affine3d& transform = value.emplace<Eigen::Affine3d>();
+        transform = Eigen::Translation3d(1.0, 2.0, 3.0);
+
+        const any copy(value);
+        ROBOTSIO_CHECK(any_cast<const Eigen::Affine3d&>(copy).translation().isApprox(Eigen::Vector3d(1.0, 2.0, 3.0)));
+
+        Counted& counted = value.emplace<Counted>(10);
+        ROBOTSIO_CHECK(counted.value == 10);
+        ROBOTSIO_CHECK(Counted::instances == 1);
+    }
+    ROBOTSIO_CHECK(Counted::instances == 0);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#include <Check.h>
+
+#include <RobotsIO/Utils/AsyncProbe.h>
+#include <RobotsIO/Utils/Data.h>
+#include <RobotsIO/Utils/Probe.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+using namespace RobotsIO::Utils;
+
+namespace
+{
+    /* Throws for odd values. */
+    class OddThrowingProbe : public Probe
+    {
+    public:
+        OddThrowingProbe(std::atomic<int>& sum) :
+            sum_(sum)
+        { }
+
+    protected:
+        void on_new_data() override
+        {
+            const int value = any_cast<int>(get_data());
+            if (value % 2 == 1)
+                throw(std::runtime_error("odd value"));
+
+            sum_ += value;
+        }
+
+    private:
+        std::atomic<int>& sum_;
+    };
+
+
+    /* Records the values and blocks the worker thread on the first one, until opened. */
+    class GatedProbe : public Probe
+    {
+    public:
+        void wait_blocked()
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            condition_.wait(lock, [this]{ return !values_.empty(); });
+        }
+
+        void open()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                open_ = true;
+            }
+            condition_.notify_all();
+        }
+
+        std::vector<int> values() const
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return values_;
+        }
+
+    protected:
+        void on_new_data() override
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            values_.push_back(any_cast<int>(get_data()));
+            condition_.notify_all();
+            condition_.wait(lock, [this]{ return open_; });
+        }
+
+    private:
+        std::vector<int> values_;
+
+        bool open_ = false;
+
+        mutable std::mutex mutex_;
+
+        std::condition_variable condition_;
+    };
+
+
+    /*
+     * With the worker blocked on value 0 and a queue of two slots, values 1 to 4 overflow the queue by two.
+     * The values dispatched and the counters are returned once the queue is drained.
+     */
+    std::vector<int> fill_blocked_queue(const AsyncProbe::Policy& policy, AsyncProbe::Counters& counters)
+    {
+        GatedProbe* gated = new GatedProbe();
+        AsyncProbe probe(std::unique_ptr<Probe>(gated), 2, policy);
+
+        probe.set_data(Data(0));
+        gated->wait_blocked();
+
+        for (int i = 1; i < 5; i++)
+            probe.set_data(Data(i));
+
+        gated->open();
+        while (probe.counters().dispatched < 3);
+        counters = probe.counters();
+
+        return gated->values();
+    }
+}
+
+
+int main()
+{
+    std::atomic<int> sum(0);
+    AsyncProbe::Counters counters;
+
+    {
+        AsyncProbe probe(std::unique_ptr<Probe>(new OddThrowingProbe(sum)), 4, AsyncProbe::Policy::Block);
+
+        for (int i = 0; i < 10; i++)
+            probe.set_data(Data(i));
+
+        /* Queued data is dispatched on destruction, hence the worker survives the exceptions. */
+    }
+
+    {
+        AsyncProbe probe(std::unique_ptr<Probe>(new OddThrowingProbe(sum)), 4, AsyncProbe::Policy::Block);
+        probe.set_data(Data(1));
+        probe.set_data(Data(2));
+        probe.set_data(Data(3));
+
+        while (probe.counters().dispatched < 3);
+        counters = probe.counters();
+    }
+
+    ROBOTSIO_CHECK(sum == 0 + 2 + 4 + 6 + 8 + 2);
+    ROBOTSIO_CHECK(counters.enqueued == 3);
+    ROBOTSIO_CHECK(counters.dispatched == 3);
+    ROBOTSIO_CHECK(counters.failed == 2);
+    ROBOTSIO_CHECK(counters.dropped == 0);
+
+    /* The oldest queued data is evicted in favour of the newest. */
+    ROBOTSIO_CHECK(fill_blocked_queue(AsyncProbe::Policy::DropOldest, counters) == std::vector<int>({0, 3, 4}));
+    ROBOTSIO_CHECK(counters.enqueued == 5);
+    ROBOTSIO_CHECK(counters.dispatched == 3);
+    ROBOTSIO_CHECK(counters.dropped == 2);
+    ROBOTSIO_CHECK(counters.failed == 0);
+
+    /* The newest data is dropped without being enqueued. */
+    ROBOTSIO_CHECK(fill_blocked_queue(AsyncProbe::Policy::DropNewest, counters) == std::vector<int>({0, 1, 2}));
+    ROBOTSIO_CHECK(counters.enqueued == 3);
+    ROBOTSIO_CHECK(counters.dispatched == 3);
+    ROBOTSIO_CHECK(counters.dropped == 2);
+    ROBOTSIO_CHECK(counters.failed == 0);
+
+    return EXIT_SUCCESS;
+}
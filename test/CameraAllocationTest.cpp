@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#include <Check.h>
+
+#include <RobotsIO/Camera/Camera.h>
+
+#include <Eigen/Dense>
+
+#include <opencv2/opencv.hpp>
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+
+using namespace Eigen;
+using namespace RobotsIO::Camera;
+
+
+/**
+ * Allocations are counted by replacing the glibc allocation functions, which are also used by operator new.
+ */
+
+extern "C"
+{
+    void* __libc_malloc(std::size_t size);
+
+    void* __libc_calloc(std::size_t number, std::size_t size);
+
+    void* __libc_realloc(void* pointer, std::size_t size);
+
+    void* __libc_memalign(std::size_t alignment, std::size_t size);
+}
+
+
+namespace
+{
+    std::atomic<bool> count_allocations(false);
+
+    std::atomic<std::size_t> number_allocations(0);
+
+
+    void* count(void* pointer)
+    {
+        if (count_allocations.load(std::memory_order_relaxed))
+            number_allocations.fetch_add(1, std::memory_order_relaxed);
+
+        return pointer;
+    }
+}
+
+
+extern "C"
+{
+    void* malloc(std::size_t size)
+    {
+        return count(__libc_malloc(size));
+    }
+
+
+    void* calloc(std::size_t number, std::size_t size)
+    {
+        return count(__libc_calloc(number, size));
+    }
+
+
+    void* realloc(void* pointer, std::size_t size)
+    {
+        return count(__libc_realloc(pointer, size));
+    }
+
+
+    void* aligned_alloc(std::size_t alignment, std::size_t size)
+    {
+        return count(__libc_memalign(alignment, size));
+    }
+
+
+    int posix_memalign(void** pointer, std::size_t alignment, std::size_t size)
+    {
+        *pointer = count(__libc_memalign(alignment, size));
+
+        return (*pointer == nullptr) ? ENOMEM : 0;
+    }
+}
+
+
+namespace
+{
+    /**
+     * Camera providing a synthetic frame through the allocation free overloads.
+     *
+     * Only the base class is covered, as the acquisition of the concrete cameras involves YARP and OpenCV,
+     * whose allocations are outside the control of this library.
+     */
+    class SyntheticCamera : public Camera
+    {
+    public:
+        EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+        SyntheticCamera(const std::size_t& width, const std::size_t& height)
+        {
+            parameters_.width = width;
+            parameters_.height = height;
+            parameters_.fx = 500.0;
+            parameters_.cx = width / 2.0;
+            parameters_.fy = 500.0;
+            parameters_.cy = height / 2.0;
+            parameters_.set_initialized();
+
+            initialize();
+
+            /* One pixel every four has an invalid depth. */
+            depth_.resize(height, width);
+            for (std::size_t v = 0; v < height; v++)
+                for (std::size_t u = 0; u < width; u++)
+                    depth_(v, u) = ((u + v) % 4 == 0) ? 0.0 : 0.5 + 0.001 * u;
+
+            rgb_.create(height, width, CV_8UC3);
+            for (std::size_t v = 0; v < height; v++)
+                for (std::size_t u = 0; u < width; u++)
+                    rgb_.at<cv::Vec3b>(v, u) = cv::Vec3b{{static_cast<unsigned char>(u), static_cast<unsigned char>(v), 0}};
+
+            pose_ = Translation<double, 3>(0.1, 0.2, 0.3);
+        }
+
+        std::pair<bool, MatrixXf> depth(const bool& blocking) override
+        {
+            return std::make_pair(true, depth_);
+        }
+
+        bool depth(const bool& blocking, MatrixXf& depth) override
+        {
+            depth = depth_;
+
+            return true;
+        }
+
+        std::pair<bool, Transform<double, 3, Affine>> pose(const bool& blocking) override
+        {
+            return std::make_pair(true, pose_);
+        }
+
+        std::pair<bool, cv::Mat> rgb(const bool& blocking) override
+        {
+            return std::make_pair(true, rgb_.clone());
+        }
+
+        bool rgb(const bool& blocking, cv::Mat& rgb) override
+        {
+            rgb_.copyTo(rgb);
+
+            return true;
+        }
+
+    private:
+        MatrixXf depth_;
+
+        cv::Mat rgb_;
+
+        Transform<double, 3, Affine> pose_;
+    };
+}
+
+
+int main()
+{
+    const std::size_t width = 320;
+    const std::size_t height = 240;
+    const std::size_t number_points = width * height - (width * height) / 4;
+    const std::size_t number_iterations = 100;
+
+    std::unique_ptr<SyntheticCamera> camera(new SyntheticCamera(width, height));
+
+    /* The first call allocates the internal buffers and the output. */
+    MatrixXd cloud;
+    bool valid_cloud = false;
+    std::size_t number_valids = 0;
+    std::tie(valid_cloud, number_valids) = camera->point_cloud(true, cloud, 10.0, true, true);
+    ROBOTSIO_CHECK(valid_cloud);
+    ROBOTSIO_CHECK(number_valids == number_points);
+
+    /* In steady state, the caller-provided overload does not allocate. */
+    count_allocations = true;
+    for (std::size_t i = 0; i < number_iterations; i++)
+    {
+        std::tie(valid_cloud, number_valids) = camera->point_cloud(true, cloud, 10.0, true, true);
+        if (!valid_cloud || (number_valids != number_points))
+            break;
+    }
+    count_allocations = false;
+    ROBOTSIO_CHECK(valid_cloud);
+    ROBOTSIO_CHECK(number_allocations == 0);
+
+    /* The overload returning by value allocates the output only, having exactly one column per point. */
+    MatrixXd cloud_by_value;
+    number_allocations = 0;
+    count_allocations = true;
+    std::tie(valid_cloud, cloud_by_value) = camera->point_cloud(true, 10.0, true, true);
+    count_allocations = false;
+    ROBOTSIO_CHECK(valid_cloud);
+    ROBOTSIO_CHECK(number_allocations == 1);
+    ROBOTSIO_CHECK(std::size_t(cloud_by_value.cols()) == number_points);
+    ROBOTSIO_CHECK(cloud_by_value.isApprox(cloud.leftCols(number_points)));
+
+    /* Points are expressed in the root frame. */
+    const Vector3d point = cloud_by_value.col(0).head<3>() - Vector3d(0.1, 0.2, 0.3);
+    ROBOTSIO_CHECK(point(2) > 0.0);
+
+    return EXIT_SUCCESS;
+}
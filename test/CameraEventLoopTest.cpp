@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#include <Check.h>
+
+#include <RobotsIO/Camera/CameraEventLoop.h>
+#include <RobotsIO/Camera/YarpCamera.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <future>
+#include <stdexcept>
+#include <thread>
+
+#include <yarp/os/BufferedPort.h>
+#include <yarp/os/Network.h>
+#include <yarp/os/Stamp.h>
+#include <yarp/sig/Image.h>
+
+using namespace RobotsIO::Camera;
+using namespace yarp::os;
+using namespace yarp::sig;
+
+
+namespace
+{
+    /**
+     * Publishes a small image, filled with the given value in the red channel.
+     */
+    void publish(BufferedPort<ImageOf<PixelRgb>>& port, const unsigned char& value)
+    {
+        ImageOf<PixelRgb>& image = port.prepare();
+        image.resize(8, 6);
+        for (std::size_t v = 0; v < image.height(); v++)
+            for (std::size_t u = 0; u < image.width(); u++)
+            {
+                image.pixel(u, v).r = value;
+                image.pixel(u, v).g = 0;
+                image.pixel(u, v).b = 0;
+            }
+
+        Stamp stamp(static_cast<int>(value), static_cast<double>(value));
+        port.setEnvelope(stamp);
+        port.writeStrict();
+    }
+
+
+    /**
+     * The value published in the red channel, i.e. the last channel of the BGR image.
+     */
+    int value_of(const CameraEventLoop::FrameHandle& frame)
+    {
+        return frame->rgb.at<cv::Vec3b>(0, 0)[2];
+    }
+
+
+    bool is_ready(std::future<CameraEventLoop::FrameHandle>& future, const double& seconds)
+    {
+        return future.wait_for(std::chrono::duration<double>(seconds)) == std::future_status::ready;
+    }
+}
+
+
+int main()
+{
+    /* The fake image publisher and the camera share a name server local to the process. */
+    Network::setLocalMode(true);
+    Network yarp;
+
+    YarpCamera camera(8, 6, 10.0, 4.0, 10.0, 3.0, "robots-io-test-loop");
+
+    BufferedPort<ImageOf<PixelRgb>> rgb;
+    ROBOTSIO_CHECK(rgb.open("/robots-io-test-loop/rgb:o"));
+    ROBOTSIO_CHECK(Network::connect("/robots-io-test-loop/rgb:o", "/robots-io-test-loop/rgbImage:i"));
+
+    CameraEventLoop loop(camera, false);
+
+    /* A frame received while no one is waiting is not delivered to a later request. */
+    publish(rgb, 1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    std::future<CameraEventLoop::FrameHandle> future = loop.next_frame();
+    ROBOTSIO_CHECK(!is_ready(future, 0.2));
+
+    publish(rgb, 2);
+    ROBOTSIO_CHECK(is_ready(future, 5.0));
+    CameraEventLoop::FrameHandle frame = future.get();
+    ROBOTSIO_CHECK(frame != nullptr);
+    ROBOTSIO_CHECK(value_of(frame) == 2);
+
+    /* A callback throwing is counted, while the other callbacks and the loop keep running. */
+    std::atomic<int> last_value(0);
+    const std::size_t throwing_id = loop.add_callback([](const CameraEventLoop::FrameHandle&) { throw(std::runtime_error("callback")); });
+    const std::size_t id = loop.add_callback([&last_value](const CameraEventLoop::FrameHandle& frame) { last_value = value_of(frame); });
+
+    publish(rgb, 3);
+    for (std::size_t i = 0; (i < 500) && (last_value != 3); i++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    ROBOTSIO_CHECK(last_value == 3);
+    ROBOTSIO_CHECK(loop.number_failures() == 1);
+    ROBOTSIO_CHECK(loop.is_running());
+
+    loop.remove_callback(throwing_id);
+    loop.remove_callback(id);
+
+    future = loop.next_frame();
+    publish(rgb, 4);
+    ROBOTSIO_CHECK(is_ready(future, 5.0));
+    ROBOTSIO_CHECK(value_of(future.get()) == 4);
+    ROBOTSIO_CHECK(loop.number_failures() == 1);
+
+    loop.stop();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,27 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef ROBOTSIO_TEST_CHECK_H
+#define ROBOTSIO_TEST_CHECK_H
+
+#include <cstdlib>
+#include <iostream>
+
+/**
+ * Makes the test fail, returning from main(), if the condition does not hold.
+ */
+#define ROBOTSIO_CHECK(condition)                                                                       \
+    do                                                                                                  \
+    {                                                                                                   \
+        if (!(condition))                                                                               \
+        {                                                                                               \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " << #condition << std::endl;  \
+            return EXIT_FAILURE;                                                                        \
+        }                                                                                               \
+    } while (false)
+
+#endif /* ROBOTSIO_TEST_CHECK_H */
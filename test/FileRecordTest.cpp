@@ -0,0 +1,254 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#include <Check.h>
+
+#include <RobotsIO/Utils/FileImageProbe.h>
+#include <RobotsIO/Utils/FileMatrixProbe.hpp>
+#include <RobotsIO/Utils/FileRecordReader.h>
+#include <RobotsIO/Utils/FileRecordWriter.h>
+
+#include <Eigen/Dense>
+
+#include <opencv2/opencv.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace Eigen;
+using namespace RobotsIO::Utils;
+
+/**
+ * Records written by FileMatrixProbe, FileImageProbe and FileRecordWriter, read back using FileRecordReader.
+ *
+ * Batches are small, such that records are split among several writes of the worker thread.
+ */
+
+namespace
+{
+    const std::size_t batch_size = 64;
+
+
+    bool is_batch_size_accepted(const std::string& path, const std::size_t& size)
+    {
+        try
+        {
+            FileRecordWriter writer(path, size);
+        }
+        catch (const std::runtime_error&)
+        {
+            return false;
+        }
+
+        return true;
+    }
+
+
+    cv::Mat make_image()
+    {
+        cv::Mat image(6, 8, CV_8UC3);
+        for (int v = 0; v < image.rows; v++)
+            for (int u = 0; u < image.cols; u++)
+            {
+                cv::Vec3b& pixel = image.at<cv::Vec3b>(v, u);
+                pixel[0] = static_cast<unsigned char>(u);
+                pixel[1] = static_cast<unsigned char>(v);
+                pixel[2] = static_cast<unsigned char>(u * v);
+            }
+
+        return image;
+    }
+
+
+    bool is_same_image(const cv::Mat& a, const cv::Mat& b)
+    {
+        if ((a.rows != b.rows) || (a.cols != b.cols) || (a.type() != b.type()))
+            return false;
+
+        for (int v = 0; v < a.rows; v++)
+            for (int u = 0; u < a.cols; u++)
+                for (int c = 0; c < 3; c++)
+                    if (a.at<cv::Vec3b>(v, u)[c] != b.at<cv::Vec3b>(v, u)[c])
+                        return false;
+
+        return true;
+    }
+
+
+    bool is_sorted(const FileRecordReader& reader)
+    {
+        double previous = 0.0;
+        for (std::size_t i = 0; i < reader.number_records(); i++)
+        {
+            bool valid_timestamp = false;
+            double timestamp;
+            std::tie(valid_timestamp, timestamp) = reader.timestamp(i);
+            if (!valid_timestamp || (timestamp < previous))
+                return false;
+            previous = timestamp;
+        }
+
+        return true;
+    }
+
+
+    int check_matrices(const std::string& path)
+    {
+        const MatrixXd matrix = MatrixXd::Random(3, 40);
+        const Matrix<double, 2, 3, RowMajor> row_major = Matrix<double, 2, 3, RowMajor>::Random();
+
+        Transform<double, 3, Affine> transform = Transform<double, 3, Affine>::Identity();
+        transform.translate(Vector3d(0.1, -0.2, 0.3));
+        transform.rotate(AngleAxisd(0.5, Vector3d(1.0, 2.0, -1.0).normalized()));
+
+        {
+            FileMatrixProbe<MatrixXd> matrix_probe(path + "matrix.log", batch_size);
+            for (std::size_t i = 0; i < 10; i++)
+            {
+                const MatrixXd scaled = matrix * i;
+                matrix_probe.set_data(scaled);
+            }
+            ROBOTSIO_CHECK(matrix_probe.flush());
+
+            FileMatrixProbe<Matrix<double, 2, 3, RowMajor>> row_major_probe(path + "row_major.log", batch_size);
+            row_major_probe.set_data(row_major);
+
+            FileMatrixProbe<Transform<double, 3, Affine>> transform_probe(path + "transform.log", batch_size);
+            transform_probe.set_data(transform);
+        }
+
+        FileRecordReader matrix_reader(path + "matrix.log");
+        ROBOTSIO_CHECK(matrix_reader.number_records() == 10);
+        ROBOTSIO_CHECK(is_sorted(matrix_reader));
+
+        /* Records are read in any order. */
+        double timestamp;
+        MatrixXd data;
+        for (std::size_t i = 10; i > 0; i--)
+        {
+            ROBOTSIO_CHECK(matrix_reader.read_matrix(i - 1, timestamp, data));
+            ROBOTSIO_CHECK(data == matrix * (i - 1));
+        }
+        ROBOTSIO_CHECK(!matrix_reader.read_matrix(10, timestamp, data));
+
+        FileRecordReader row_major_reader(path + "row_major.log");
+        ROBOTSIO_CHECK(row_major_reader.read_matrix(0, timestamp, data));
+        ROBOTSIO_CHECK(data == MatrixXd(row_major));
+
+        /* Transformations are stored as x-y-z-axis-angle. */
+        FileRecordReader transform_reader(path + "transform.log");
+        ROBOTSIO_CHECK(transform_reader.read_matrix(0, timestamp, data));
+        ROBOTSIO_CHECK((data.rows() == 7) && (data.cols() == 1));
+
+        Transform<double, 3, Affine> read_transform = Transform<double, 3, Affine>::Identity();
+        read_transform.translate(Vector3d(data.col(0).head<3>()));
+        read_transform.rotate(AngleAxisd(data(6, 0), data.col(0).segment<3>(3)));
+        ROBOTSIO_CHECK(read_transform.isApprox(transform, 1e-12));
+
+        return EXIT_SUCCESS;
+    }
+
+
+    int check_images(const std::string& path)
+    {
+        const cv::Mat image = make_image();
+
+        {
+            FileImageProbe raw_probe(path + "raw.log", FileImageProbe::Codec::Raw, -1, batch_size);
+            raw_probe.set_data(image);
+            raw_probe.set_data(image);
+
+            FileImageProbe png_probe(path + "png.log", FileImageProbe::Codec::Png, 3, batch_size);
+            png_probe.set_data(image);
+        }
+
+        double timestamp;
+        cv::Mat data;
+
+        FileRecordReader raw_reader(path + "raw.log");
+        ROBOTSIO_CHECK(raw_reader.number_records() == 2);
+        ROBOTSIO_CHECK(raw_reader.read_image(1, timestamp, data));
+        ROBOTSIO_CHECK(is_same_image(data, image));
+
+        /* PNG is lossless. */
+        FileRecordReader png_reader(path + "png.log");
+        ROBOTSIO_CHECK(png_reader.number_records() == 1);
+        ROBOTSIO_CHECK(png_reader.read_image(0, timestamp, data));
+        ROBOTSIO_CHECK(is_same_image(data, image));
+
+        /* An image is not a matrix. */
+        MatrixXd matrix;
+        ROBOTSIO_CHECK(!raw_reader.read_matrix(0, timestamp, matrix));
+
+        return EXIT_SUCCESS;
+    }
+
+
+    int check_corrupted(const std::string& path)
+    {
+        ROBOTSIO_CHECK(!is_batch_size_accepted(path + "corrupted.log", 0));
+
+        {
+            FileRecordWriter writer(path + "corrupted.log", batch_size);
+
+            /* The number of bytes of the shape wraps around to zero. */
+            const std::uint64_t overflowing_shape[2] = {std::uint64_t(1) << 62, 4};
+            ROBOTSIO_CHECK(writer.write(1.0, reinterpret_cast<const char*>(overflowing_shape), sizeof(overflowing_shape)));
+
+            /* A shape smaller than the data. */
+            const std::uint64_t shape[2] = {2, 2};
+            const double values[6] = {};
+            ROBOTSIO_CHECK(writer.write(2.0, reinterpret_cast<const char*>(shape), sizeof(shape), reinterpret_cast<const char*>(values), sizeof(values)));
+
+            /* A record shorter than the shape. */
+            ROBOTSIO_CHECK(writer.write(3.0, "abc", 3));
+        }
+
+        FileRecordReader reader(path + "corrupted.log");
+        ROBOTSIO_CHECK(reader.number_records() == 3);
+
+        double timestamp;
+        MatrixXd data;
+        for (std::size_t i = 0; i < 3; i++)
+            ROBOTSIO_CHECK(!reader.read_matrix(i, timestamp, data));
+
+        std::vector<char> raw;
+        ROBOTSIO_CHECK(reader.read(2, timestamp, raw));
+        ROBOTSIO_CHECK((timestamp == 3.0) && (std::string(raw.begin(), raw.end()) == "abc"));
+
+        return EXIT_SUCCESS;
+    }
+}
+
+
+int main()
+{
+    char path_template[] = "/tmp/robots-io-test-XXXXXX";
+    if (mkdtemp(path_template) == nullptr)
+        return EXIT_FAILURE;
+
+    const std::string path = std::string(path_template) + "/";
+
+    int result = check_matrices(path);
+    if (result == EXIT_SUCCESS)
+        result = check_images(path);
+    if (result == EXIT_SUCCESS)
+        result = check_corrupted(path);
+
+    for (const std::string name : {"matrix.log", "row_major.log", "transform.log", "raw.log", "png.log", "corrupted.log"})
+    {
+        std::remove((path + name).c_str());
+        std::remove((path + name + ".index").c_str());
+    }
+    std::remove(path.c_str());
+
+    return result;
+}
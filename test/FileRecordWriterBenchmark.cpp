@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#include <RobotsIO/Utils/FileMatrixProbe.hpp>
+
+#include <Eigen/Dense>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using namespace Eigen;
+using namespace RobotsIO::Utils;
+
+/**
+ * Throughput of FileMatrixProbe, from setting the data to having it stored on disk, for records of increasing size.
+ * The log is written to the path given as argument, by default in the current directory, and removed afterwards.
+ */
+
+int main(int argc, char** argv)
+{
+    const std::string path = (argc > 1) ? argv[1] : "robots-io-benchmark.log";
+
+    /* Encoders of an arm, a 160x120 and a 640x480 point cloud with colors. */
+    const std::size_t rows[] = {16, 6, 6};
+    const std::size_t cols[] = {1, 160 * 120, 640 * 480};
+
+    const double megabytes_per_size = 256;
+
+    std::cout << "record\trecords/s\tMB/s" << std::endl;
+
+    for (std::size_t i = 0; i < 3; i++)
+    {
+        const MatrixXd matrix = MatrixXd::Random(rows[i], cols[i]);
+        const double record_megabytes = (2 * sizeof(std::uint64_t) + matrix.size() * sizeof(double)) / 1e6;
+        const std::size_t records = static_cast<std::size_t>(megabytes_per_size / record_megabytes);
+
+        std::chrono::steady_clock::time_point start;
+        std::chrono::steady_clock::time_point end;
+        {
+            FileMatrixProbe<MatrixXd> probe(path);
+
+            start = std::chrono::steady_clock::now();
+            for (std::size_t j = 0; j < records; j++)
+                probe.set_data(matrix);
+
+            if (!probe.flush())
+            {
+                std::cerr << "Cannot write to " << path << "." << std::endl;
+                return EXIT_FAILURE;
+            }
+            end = std::chrono::steady_clock::now();
+        }
+
+        const double seconds = std::chrono::duration<double>(end - start).count();
+
+        std::cout << rows[i] << "x" << cols[i] << "\t" << records / seconds << "\t" << records * record_megabytes / seconds << std::endl;
+    }
+
+    std::remove(path.c_str());
+    std::remove((path + ".index").c_str());
+
+    return EXIT_SUCCESS;
+}
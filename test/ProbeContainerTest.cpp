@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#include <Check.h>
+
+#include <Eigen/Dense>
+
+#include <RobotsIO/Utils/AsyncProbe.h>
+#include <RobotsIO/Utils/Data.h>
+#include <RobotsIO/Utils/ProbeContainer.h>
+#include <RobotsIO/Utils/ProbeStatistics.h>
+#include <RobotsIO/Utils/ProbeThrottle.h>
+#include <RobotsIO/Utils/TypedProbe.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace RobotsIO::Utils;
+
+namespace
+{
+    class SumProbe : public TypedProbe<int>
+    {
+    public:
+        SumProbe(std::atomic<int>& sum) :
+            sum_(sum)
+        { }
+
+    protected:
+        void on_new_typed_data(const int& data) override
+        {
+            sum_ += data;
+        }
+
+    private:
+        std::atomic<int>& sum_;
+    };
+
+
+    bool set_decimation(ProbeContainer& container, const std::size_t& decimation)
+    {
+        ProbeThrottle::Policy policy;
+        policy.decimation = decimation;
+
+        try
+        {
+            container.set_probe_policy("sum", policy);
+        }
+        catch (const std::runtime_error&)
+        {
+            return false;
+        }
+
+        return true;
+    }
+}
+
+
+int main()
+{
+    std::atomic<int> sum(0);
+
+    ProbeContainer container;
+    container.set_probe("sum", std::unique_ptr<Probe>(new SumProbe(sum)));
+
+    ROBOTSIO_CHECK(!set_decimation(container, 0));
+    ROBOTSIO_CHECK(container.get_probe("sum").get_throttle() == nullptr);
+
+    /* The throttle applies to the typed interface, while the probe is still returned by get_typed_probe(). */
+    ROBOTSIO_CHECK(set_decimation(container, 2));
+    TypedProbe<int>* probe = container.get_typed_probe<int>("sum");
+    ROBOTSIO_CHECK(probe != nullptr);
+
+    for (int i = 0; i < 4; i++)
+        probe->set_data(i);
+    ROBOTSIO_CHECK(sum == 0 + 2);
+    ROBOTSIO_CHECK(probe->statistics().snapshot().dropped == 2);
+
+    /* Changing the decimation keeps the counters of the throttle. */
+    ROBOTSIO_CHECK(set_decimation(container, 1));
+    ROBOTSIO_CHECK(probe->get_throttle()->number_dropped() == 2);
+
+    /* Coalescing wraps the probe, and disabling it unwraps the same probe. */
+    ProbeThrottle::Policy policy;
+    policy.coalesce = true;
+    container.set_probe_policy("sum", policy);
+    ROBOTSIO_CHECK(container.get_typed_probe<int>("sum") == nullptr);
+    ROBOTSIO_CHECK(dynamic_cast<AsyncProbe*>(&container.get_probe("sum")) != nullptr);
+
+    container.get_probe("sum").set_data(Data(10));
+
+    policy.coalesce = false;
+    container.set_probe_policy("sum", policy);
+    ROBOTSIO_CHECK(container.get_typed_probe<int>("sum") == probe);
+    ROBOTSIO_CHECK(probe->get_throttle() != nullptr);
+
+    /* Data queued by the AsyncProbe is dispatched before unwrapping. */
+    ROBOTSIO_CHECK(sum == 0 + 2 + 10);
+
+    /* Probes set afterwards get the policy. */
+    container.set_probe("sum", std::unique_ptr<Probe>(new SumProbe(sum)));
+    ROBOTSIO_CHECK(container.get_probe("sum").get_throttle() != nullptr);
+
+    /* Control characters in the names are escaped. */
+    ProbeContainer escaped_container;
+    escaped_container.set_probe(std::string("a\"\\\n\t\x01") + "b", std::unique_ptr<Probe>(new SumProbe(sum)));
+    const std::string json = escaped_container.probe_statistics_to_json();
+    ROBOTSIO_CHECK(json.find("\"a\\\"\\\\\\n\\t\\u0001b\": {") == 1);
+
+    ROBOTSIO_CHECK(probe_data_size(1.0) == sizeof(double));
+    ROBOTSIO_CHECK(probe_data_size(Eigen::VectorXd(5)) == 5 * sizeof(double));
+    ROBOTSIO_CHECK(probe_data_size(std::vector<float>(3)) == 3 * sizeof(float));
+    ROBOTSIO_CHECK(probe_data_size(std::array<int, 4>()) == 4 * sizeof(int));
+    ROBOTSIO_CHECK(probe_data_size(std::string("abc")) == 3);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#include <RobotsIO/Utils/SharedMemoryRing.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include <yarp/os/BufferedPort.h>
+#include <yarp/os/Network.h>
+#include <yarp/sig/Image.h>
+
+using namespace RobotsIO::Utils;
+using namespace yarp::os;
+using namespace yarp::sig;
+
+/**
+ * Compares SharedMemoryRing with YARP ports, using the tcp and the local carriers, for 640x480 RGB images.
+ *
+ * Each image is written only once the reader has copied the previous one and acknowledged it,
+ * such that the time per image is the latency of a round trip, without images being skipped.
+ */
+
+namespace
+{
+    const std::size_t width = 640;
+
+    const std::size_t height = 480;
+
+    const std::size_t image_size = width * height * 3;
+
+    const std::size_t frames = 500;
+
+
+    void wait_ack(const std::atomic<std::size_t>& ack, const std::size_t& frame)
+    {
+        while (ack.load() < frame)
+            std::this_thread::yield();
+    }
+
+
+    void report(const std::string& transport, const std::chrono::steady_clock::duration& duration)
+    {
+        const double seconds = std::chrono::duration<double>(duration).count();
+
+        std::cout << transport << "\t" << seconds / frames * 1e6 << "\t" << frames * image_size / seconds / 1e6 << std::endl;
+    }
+
+
+    std::chrono::steady_clock::duration benchmark_ring()
+    {
+        SharedMemoryRing writer("/robots-io-benchmark-ring", 4, image_size);
+        SharedMemoryRing reader("/robots-io-benchmark-ring");
+
+        const std::vector<char> image(image_size, 1);
+        std::atomic<std::size_t> ack(0);
+
+        std::thread reader_thread([&]()
+        {
+            std::vector<char> copy(image_size);
+            std::uint64_t sequence = 0;
+
+            while (sequence < frames)
+            {
+                reader.wait_newer(sequence);
+
+                bool valid_view = false;
+                SharedMemoryRing::View view;
+                std::tie(valid_view, view) = reader.view_latest();
+                if (!valid_view)
+                    continue;
+
+                std::memcpy(copy.data(), view.data, view.size);
+                if (!reader.is_valid(view))
+                    continue;
+
+                sequence = view.sequence;
+                ack.store(sequence);
+            }
+        });
+
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (std::size_t i = 1; i <= frames; i++)
+        {
+            writer.write(0.0, {{static_cast<std::int32_t>(SharedMemoryRing::Content::Raw), 0, 0, 0}}, image.data(), image.size());
+            wait_ack(ack, i);
+        }
+        const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+        reader_thread.join();
+
+        return end - start;
+    }
+
+
+    std::chrono::steady_clock::duration benchmark_yarp(const std::string& carrier)
+    {
+        BufferedPort<ImageOf<PixelRgb>> output;
+        BufferedPort<ImageOf<PixelRgb>> input;
+        if (!output.open("/robots-io-benchmark/image:o") || !input.open("/robots-io-benchmark/image:i") ||
+            !Network::connect("/robots-io-benchmark/image:o", "/robots-io-benchmark/image:i", carrier))
+        {
+            std::cerr << "Cannot connect the ports using the " << carrier << " carrier." << std::endl;
+            std::exit(EXIT_FAILURE);
+        }
+        input.setStrict();
+
+        std::atomic<std::size_t> ack(0);
+
+        std::thread reader_thread([&]()
+        {
+            std::vector<char> copy(image_size);
+
+            for (std::size_t i = 1; i <= frames; i++)
+            {
+                ImageOf<PixelRgb>* image = input.read(true);
+                if (image == nullptr)
+                    return;
+
+                std::memcpy(copy.data(), image->getRawImage(), std::min(image->getRawImageSize(), image_size));
+                ack.store(i);
+            }
+        });
+
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (std::size_t i = 1; i <= frames; i++)
+        {
+            ImageOf<PixelRgb>& image = output.prepare();
+            image.resize(width, height);
+            std::memset(image.getRawImage(), 1, image.getRawImageSize());
+            output.writeStrict();
+
+            wait_ack(ack, i);
+        }
+        const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+        reader_thread.join();
+
+        output.close();
+        input.close();
+
+        return end - start;
+    }
+}
+
+
+int main()
+{
+    /* The ports share a name server local to the process. */
+    Network::setLocalMode(true);
+    Network yarp;
+
+    std::cout << "transport\tus/image\tMB/s" << std::endl;
+
+    report("SharedMemoryRing", benchmark_ring());
+
+    report("YARP tcp", benchmark_yarp("tcp"));
+
+    report("YARP local", benchmark_yarp("local"));
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#include <Check.h>
+
+#include <RobotsIO/Utils/SharedMemoryRing.h>
+
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+
+using namespace RobotsIO::Utils;
+
+
+namespace
+{
+    const std::string name = "/robots-io-test-ring";
+
+    bool write_value(SharedMemoryRing& ring, const std::int32_t& value)
+    {
+        const std::array<std::int32_t, 4> description = {{static_cast<std::int32_t>(SharedMemoryRing::Content::Raw), value, 0, 0}};
+
+        return ring.write(static_cast<double>(value), description, reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+
+    /* The value of the latest data, -1 if none is available. */
+    std::int32_t latest_value(const SharedMemoryRing& ring)
+    {
+        bool valid_view = false;
+        SharedMemoryRing::View view;
+        std::tie(valid_view, view) = ring.view_latest();
+        if (!valid_view || (view.size != sizeof(std::int32_t)))
+            return -1;
+
+        std::int32_t value;
+        std::memcpy(&value, view.data, sizeof(value));
+
+        return ring.is_valid(view) ? value : -1;
+    }
+
+
+    bool can_open()
+    {
+        try
+        {
+            SharedMemoryRing ring(name);
+        }
+        catch (const std::runtime_error&)
+        {
+            return false;
+        }
+
+        return true;
+    }
+}
+
+
+int main()
+{
+    std::unique_ptr<SharedMemoryRing> writer(new SharedMemoryRing(name, 4, 64));
+    ROBOTSIO_CHECK(write_value(*writer, 1));
+    ROBOTSIO_CHECK(!writer->write(0.0, {{0, 0, 0, 0}}, nullptr, 65));
+
+    SharedMemoryRing reader(name);
+    ROBOTSIO_CHECK(reader.slot_size() == 64);
+    ROBOTSIO_CHECK(reader.latest_sequence() == 1);
+    ROBOTSIO_CHECK(latest_value(reader) == 1);
+
+    /* A restarted writer, with a different geometry, creates a new ring, while the mapped one stays readable. */
+    std::unique_ptr<SharedMemoryRing> restarted_writer(new SharedMemoryRing(name, 2, 4096));
+    ROBOTSIO_CHECK(write_value(*restarted_writer, 2));
+
+    ROBOTSIO_CHECK(reader.latest_sequence() == 1);
+    ROBOTSIO_CHECK(latest_value(reader) == 1);
+    ROBOTSIO_CHECK(!reader.wait_newer(1, 0.01));
+
+    /* The previous writer does not remove the ring of the restarted one. */
+    writer.reset();
+    ROBOTSIO_CHECK(latest_value(reader) == 1);
+
+    SharedMemoryRing new_reader(name);
+    ROBOTSIO_CHECK(new_reader.slot_size() == 4096);
+    ROBOTSIO_CHECK(latest_value(new_reader) == 2);
+
+    ROBOTSIO_CHECK(write_value(*restarted_writer, 3));
+    ROBOTSIO_CHECK(new_reader.wait_newer(1, 1.0));
+    ROBOTSIO_CHECK(latest_value(new_reader) == 3);
+
+    restarted_writer.reset();
+    ROBOTSIO_CHECK(!can_open());
+
+    return EXIT_SUCCESS;
+}
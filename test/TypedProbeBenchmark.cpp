@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#include <RobotsIO/Utils/Data.h>
+#include <RobotsIO/Utils/TypedProbe.hpp>
+
+#include <Eigen/Dense>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+using namespace Eigen;
+using namespace RobotsIO::Utils;
+
+/**
+ * Compares the cost of publishing a vector through the typed interface of TypedProbe,
+ * i.e. by reference, and through the type-erased interface of Probe, i.e. wrapping the vector in a Data.
+ */
+
+namespace
+{
+    class SumProbe : public TypedProbe<VectorXd>
+    {
+    public:
+        double sum = 0.0;
+
+    protected:
+        void on_new_typed_data(const VectorXd& data) override
+        {
+            sum += data(0);
+        }
+    };
+
+
+    template<class Publish>
+    double nanoseconds_per_call(const std::size_t& calls, Publish publish)
+    {
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < calls; i++)
+            publish();
+        const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+        return std::chrono::duration<double, std::nano>(end - start).count() / calls;
+    }
+}
+
+
+int main()
+{
+    const std::size_t sizes[] = {6, 1024, 640 * 480};
+
+    std::cout << "size\ttyped [ns]\tany [ns]" << std::endl;
+
+    for (const std::size_t& size : sizes)
+    {
+        const VectorXd vector = VectorXd::Ones(size);
+        const std::size_t calls = std::max<std::size_t>(100, 100000000 / (size * 100));
+
+        SumProbe probe;
+
+        const double typed = nanoseconds_per_call(calls, [&]() { probe.set_data(vector); });
+
+        const double erased = nanoseconds_per_call(calls, [&]() { static_cast<Probe&>(probe).set_data(Data(vector)); });
+
+        std::cout << size << "\t" << typed << "\t" << erased << std::endl;
+
+        /* Keeps the work of the probe observable. */
+        if (probe.sum != 2.0 * calls)
+            return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
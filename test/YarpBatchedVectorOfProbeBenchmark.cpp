@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#include <RobotsIO/Utils/YarpBatchedVectorOfProbe.hpp>
+#include <RobotsIO/Utils/YarpVectorOfBatch.h>
+
+#include <Eigen/Dense>
+
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include <yarp/os/BufferedPort.h>
+#include <yarp/os/Network.h>
+#include <yarp/os/Time.h>
+#include <yarp/os/TypedReaderCallback.h>
+#include <yarp/sig/Vector.h>
+
+using namespace Eigen;
+using namespace RobotsIO::Utils;
+using namespace yarp::os;
+using namespace yarp::sig;
+
+/**
+ * Loopback of YarpBatchedVectorOfProbe towards a reader unpacking the batches, for increasing sizes of the batch.
+ * Reports the messages and the samples received per second and the CPU time of the process per sample received.
+ */
+
+namespace
+{
+    class Reader : public TypedReaderCallback<VectorOf<double>>
+    {
+    public:
+        std::atomic<std::size_t> messages{0};
+
+        std::atomic<std::size_t> samples{0};
+
+        void onRead(VectorOf<double>& batch) override
+        {
+            if (unpack_vector_of_batch(batch, timestamps_, samples_))
+            {
+                messages++;
+                samples += timestamps_.size();
+            }
+        }
+
+    private:
+        VectorXd timestamps_;
+
+        MatrixXd samples_;
+    };
+}
+
+
+int main()
+{
+    /* The probe and the reader share a name server local to the process. */
+    Network::setLocalMode(true);
+    Network yarp;
+
+    Reader reader;
+    BufferedPort<VectorOf<double>> port;
+    if (!port.open("/robots-io-benchmark/batch:i"))
+        return EXIT_FAILURE;
+    port.setStrict();
+    port.useCallback(reader);
+
+    /* Samples of the size of the encoders of an arm. */
+    const VectorXd sample = VectorXd::Ones(16);
+    const double duration = 2.0;
+
+    std::cout << "batch size\tmessages/s\tsamples/s\tCPU us/sample" << std::endl;
+
+    const std::size_t batch_sizes[] = {1, 10, 100};
+
+    for (const std::size_t& batch_size : batch_sizes)
+    {
+        {
+            YarpBatchedVectorOfProbe<VectorXd> probe("/robots-io-benchmark/batch:o", batch_size, 1.0);
+            if (!Network::connect("/robots-io-benchmark/batch:o", "/robots-io-benchmark/batch:i"))
+                return EXIT_FAILURE;
+
+            reader.messages = 0;
+            reader.samples = 0;
+
+            const std::clock_t cpu_start = std::clock();
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+            while (std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() < duration)
+                probe.set_data(sample);
+            probe.flush();
+
+            /* Let the reader drain the messages in flight. */
+            Time::delay(0.5);
+
+            const double cpu_seconds = static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+            const std::size_t messages = reader.messages;
+            const std::size_t samples = reader.samples;
+
+            std::cout << batch_size << "\t" << messages / duration << "\t" << samples / duration << "\t"
+                      << (samples > 0 ? cpu_seconds * 1e6 / samples : 0.0) << std::endl;
+        }
+    }
+
+    port.close();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,223 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#include <Check.h>
+
+#include <RobotsIO/Utils/YarpEncodersPoller.h>
+
+#include <Eigen/Dense>
+
+#include <cstdlib>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+#include <yarp/dev/IEncodersTimed.h>
+
+using namespace Eigen;
+using namespace RobotsIO::Utils;
+
+/**
+ * Interpolation of the encoders stored by YarpEncodersPoller, sampled synchronously from fake encoders.
+ *
+ * Sample k is taken at time k and contains the joints (k, 10 k, -k).
+ */
+
+namespace
+{
+    /**
+     * Encoders returning the values and the timestamp they are set to.
+     */
+    class FakeEncoders : public yarp::dev::IEncodersTimed
+    {
+    public:
+        FakeEncoders(const std::size_t& axes) :
+            values_(axes, 0.0)
+        { }
+
+        void set(const VectorXd& values, const double& timestamp)
+        {
+            VectorXd::Map(values_.data(), values_.size()) = values;
+            timestamp_ = timestamp;
+        }
+
+        void set_available(const bool& available)
+        {
+            available_ = available;
+        }
+
+        bool getAxes(int* axes) override
+        {
+            *axes = static_cast<int>(values_.size());
+            return true;
+        }
+
+        bool getEncodersTimed(double* values, double* timestamps) override
+        {
+            if (!available_)
+                return false;
+
+            for (std::size_t i = 0; i < values_.size(); i++)
+            {
+                values[i] = values_[i];
+                timestamps[i] = timestamp_;
+            }
+
+            return true;
+        }
+
+        bool getEncoderTimed(int j, double* value, double* timestamp) override
+        {
+            *value = values_.at(j);
+            *timestamp = timestamp_;
+            return available_;
+        }
+
+        bool getEncoders(double* values) override
+        {
+            std::vector<double> timestamps(values_.size());
+            return getEncodersTimed(values, timestamps.data());
+        }
+
+        bool getEncoder(int j, double* value) override
+        {
+            double timestamp;
+            return getEncoderTimed(j, value, &timestamp);
+        }
+
+        bool resetEncoder(int) override { return false; }
+
+        bool resetEncoders() override { return false; }
+
+        bool setEncoder(int, double) override { return false; }
+
+        bool setEncoders(const double*) override { return false; }
+
+        bool getEncoderSpeed(int, double*) override { return false; }
+
+        bool getEncoderSpeeds(double*) override { return false; }
+
+        bool getEncoderAcceleration(int, double*) override { return false; }
+
+        bool getEncoderAccelerations(double*) override { return false; }
+
+    private:
+        std::vector<double> values_;
+
+        double timestamp_ = 0.0;
+
+        bool available_ = true;
+    };
+
+
+    /**
+     * Poller whose samples are taken on request, rather than by the periodic thread.
+     */
+    class SteppedPoller : public YarpEncodersPoller
+    {
+    public:
+        using YarpEncodersPoller::YarpEncodersPoller;
+
+        using YarpEncodersPoller::run;
+    };
+
+
+    VectorXd joints_of(const double& k)
+    {
+        return Vector3d(k, 10.0 * k, -k);
+    }
+
+
+    /* The first interface provides the first two joints, the second one the last joint with an older timestamp. */
+    void sample(SteppedPoller& poller, FakeEncoders& first, FakeEncoders& second, const int& k)
+    {
+        const VectorXd joints = joints_of(k);
+        first.set(joints.head<2>(), k);
+        second.set(joints.tail<1>(), k - 0.5);
+
+        poller.run();
+    }
+
+
+    bool is_equal(const std::pair<bool, VectorXd>& result, const double& k)
+    {
+        return result.first && ((result.second - joints_of(k)).norm() < 1e-9);
+    }
+
+
+    bool is_constructed(const std::vector<yarp::dev::IEncodersTimed*>& encoders, const std::size_t& history_size)
+    {
+        try
+        {
+            SteppedPoller poller(encoders, 0.01, history_size);
+        }
+        catch (const std::runtime_error&)
+        {
+            return false;
+        }
+
+        return true;
+    }
+}
+
+
+int main()
+{
+    FakeEncoders first(2);
+    FakeEncoders second(1);
+    const std::vector<yarp::dev::IEncodersTimed*> encoders = {&first, &second};
+
+    ROBOTSIO_CHECK(!is_constructed(encoders, 1));
+    ROBOTSIO_CHECK(!is_constructed({&first, nullptr}, 4));
+
+    SteppedPoller poller(encoders, 0.01, 4);
+    ROBOTSIO_CHECK(poller.number_of_joints() == 3);
+    ROBOTSIO_CHECK(!poller.encoders_at(1.0).first);
+
+    for (int k = 1; k <= 3; k++)
+        sample(poller, first, second, k);
+
+    /* Samples are interpolated, the timestamp of a sample being the newest among the interfaces. */
+    ROBOTSIO_CHECK(is_equal(poller.encoders_at(2.5), 2.5));
+    ROBOTSIO_CHECK(is_equal(poller.encoders_at(1.25), 1.25));
+    ROBOTSIO_CHECK(is_equal(poller.encoders_at(2.0), 2.0));
+    ROBOTSIO_CHECK(is_equal(poller.encoders_at(1.0), 1.0));
+
+    /* Requests newer than the newest sample return the latter, while those older than the history fail. */
+    ROBOTSIO_CHECK(is_equal(poller.encoders_at(10.0), 3.0));
+    ROBOTSIO_CHECK(!poller.encoders_at(0.5).first);
+
+    /* A failed reading does not store a sample. */
+    first.set_available(false);
+    poller.run();
+    first.set_available(true);
+
+    double timestamp;
+    VectorXd joints;
+    ROBOTSIO_CHECK(poller.latest_encoders(timestamp, joints));
+    ROBOTSIO_CHECK((timestamp == 3.0) && ((joints - joints_of(3.0)).norm() < 1e-9));
+
+    /* Once the ring buffer wraps around, the history holds samples 6 to 9 and sample 8 is stored in the first slot. */
+    for (int k = 4; k <= 9; k++)
+        sample(poller, first, second, k);
+
+    ROBOTSIO_CHECK(is_equal(poller.encoders_at(7.5), 7.5));
+    ROBOTSIO_CHECK(is_equal(poller.encoders_at(6.0), 6.0));
+    ROBOTSIO_CHECK(is_equal(poller.encoders_at(8.75), 8.75));
+    ROBOTSIO_CHECK(!poller.encoders_at(5.5).first);
+    ROBOTSIO_CHECK(!poller.encoders_at(2.5).first);
+
+    /* The overload writing into a provided output gives the same result. */
+    ROBOTSIO_CHECK(poller.encoders_at(6.5, joints));
+    ROBOTSIO_CHECK((joints - joints_of(6.5)).norm() < 1e-9);
+
+    bool valid_latest = false;
+    std::tie(valid_latest, timestamp, joints) = poller.latest_encoders();
+    ROBOTSIO_CHECK(valid_latest && (timestamp == 9.0) && ((joints - joints_of(9.0)).norm() < 1e-9));
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#include <Check.h>
+
+#include <RobotsIO/Utils/YarpFrameGrabber.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include <tuple>
+
+#include <yarp/os/BufferedPort.h>
+#include <yarp/os/Network.h>
+#include <yarp/os/Stamp.h>
+#include <yarp/sig/Image.h>
+
+using namespace RobotsIO::Utils;
+using namespace yarp::os;
+using namespace yarp::sig;
+
+
+namespace
+{
+    typedef YarpFrameGrabber<ImageOf<PixelRgb>, int> Grabber;
+
+
+    /**
+     * Publishes a small image, filled with the given value in the red channel, stamped with the given timestamp.
+     */
+    void publish(BufferedPort<ImageOf<PixelRgb>>& port, const unsigned char& value, const double& timestamp)
+    {
+        ImageOf<PixelRgb>& image = port.prepare();
+        image.resize(8, 6);
+        for (std::size_t v = 0; v < image.height(); v++)
+            for (std::size_t u = 0; u < image.width(); u++)
+            {
+                image.pixel(u, v).r = value;
+                image.pixel(u, v).g = 0;
+                image.pixel(u, v).b = 0;
+            }
+
+        Stamp stamp(static_cast<int>(value), timestamp);
+        port.setEnvelope(stamp);
+        port.writeStrict();
+    }
+
+
+    /**
+     * Frames are converted to the value published in the red channel.
+     */
+    void convert(const ImageOf<PixelRgb>& image, int& value)
+    {
+        value = image.pixel(0, 0).r;
+    }
+
+
+    bool wait_sequence(Grabber& grabber, const std::uint64_t& sequence)
+    {
+        for (std::size_t i = 0; (i < 500) && (grabber.sequence() < sequence); i++)
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+        return grabber.sequence() == sequence;
+    }
+}
+
+
+int main()
+{
+    /* The fake image publisher and the grabber share a name server local to the process. */
+    Network::setLocalMode(true);
+    Network yarp;
+
+    BufferedPort<ImageOf<PixelRgb>> input;
+    BufferedPort<ImageOf<PixelRgb>> output;
+    ROBOTSIO_CHECK(input.open("/robots-io-test-grabber/rgbImage:i"));
+    ROBOTSIO_CHECK(output.open("/robots-io-test-grabber/rgbImage:o"));
+    ROBOTSIO_CHECK(Network::connect("/robots-io-test-grabber/rgbImage:o", "/robots-io-test-grabber/rgbImage:i"));
+
+    Grabber grabber(input, convert);
+
+    std::atomic<int> number_notified(0);
+    grabber.set_listener([&number_notified]() { number_notified++; });
+
+    /* No frame is available before the first one is received. */
+    bool valid_frame = false;
+    Grabber::Frame frame;
+    std::tie(valid_frame, frame) = grabber.latest();
+    ROBOTSIO_CHECK(!valid_frame);
+    ROBOTSIO_CHECK(grabber.sequence() == 0);
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::tie(valid_frame, frame) = grabber.wait_newer(0, 0.1);
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    ROBOTSIO_CHECK(!valid_frame);
+    ROBOTSIO_CHECK((elapsed >= 0.09) && (elapsed < 5.0));
+
+    publish(output, 1, 1.5);
+    std::tie(valid_frame, frame) = grabber.wait_newer(0, 5.0);
+    ROBOTSIO_CHECK(valid_frame);
+    ROBOTSIO_CHECK((frame.sequence == 1) && (*frame.data == 1));
+    ROBOTSIO_CHECK(frame.valid_timestamp && (frame.timestamp == 1.5));
+
+    Grabber::Frame latest;
+    std::tie(valid_frame, latest) = grabber.latest();
+    ROBOTSIO_CHECK(valid_frame);
+    ROBOTSIO_CHECK((latest.sequence == 1) && (latest.data == frame.data));
+
+    /* Waiting for a frame newer than the newest one times out. */
+    std::tie(valid_frame, latest) = grabber.wait_newer(1, 0.1);
+    ROBOTSIO_CHECK(!valid_frame);
+
+    /* Sequence numbers increase in order of arrival, while frames already handed out are not modified. */
+    publish(output, 2, 2.5);
+    publish(output, 3, 3.5);
+    ROBOTSIO_CHECK(wait_sequence(grabber, 3));
+
+    std::tie(valid_frame, latest) = grabber.latest();
+    ROBOTSIO_CHECK(valid_frame);
+    ROBOTSIO_CHECK((latest.sequence == 3) && (*latest.data == 3) && (latest.timestamp == 3.5));
+    ROBOTSIO_CHECK(*frame.data == 1);
+
+    std::tie(valid_frame, latest) = grabber.wait_newer(1, 5.0);
+    ROBOTSIO_CHECK(valid_frame && (latest.sequence == 3));
+
+    /* The listener is invoked after each frame, until it is disabled. */
+    for (std::size_t i = 0; (i < 500) && (number_notified < 3); i++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    ROBOTSIO_CHECK(number_notified == 3);
+    grabber.set_listener(nullptr);
+
+    publish(output, 4, 4.5);
+    ROBOTSIO_CHECK(wait_sequence(grabber, 4));
+    ROBOTSIO_CHECK(number_notified == 3);
+
+    return EXIT_SUCCESS;
+}
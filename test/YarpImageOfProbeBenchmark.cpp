@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#include <RobotsIO/Utils/YarpImageOfProbe.hpp>
+
+#include <opencv2/opencv.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include <yarp/os/BufferedPort.h>
+#include <yarp/os/Network.h>
+#include <yarp/sig/Image.h>
+
+using namespace RobotsIO::Utils;
+using namespace yarp::os;
+using namespace yarp::sig;
+
+/**
+ * Throughput of YarpImageOfProbe<PixelRgb> publishing BGR images, i.e. converting them into the buffer of the port
+ * and writing them to a connected reader, at common resolutions.
+ */
+
+int main()
+{
+    /* The probe and the reader share a name server local to the process. */
+    Network::setLocalMode(true);
+    Network yarp;
+
+    YarpImageOfProbe<PixelRgb> probe("/robots-io-benchmark/image:o");
+
+    BufferedPort<ImageOf<PixelRgb>> reader;
+    if (!reader.open("/robots-io-benchmark/image:i") || !Network::connect("/robots-io-benchmark/image:o", "/robots-io-benchmark/image:i"))
+    {
+        std::cerr << "Cannot connect the reader." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const std::size_t frames = 500;
+
+    std::cout << "resolution\tframes/s\tMB/s" << std::endl;
+
+    for (const cv::Size& size : {cv::Size(640, 480), cv::Size(1280, 720)})
+    {
+        cv::Mat image(size, CV_8UC3, cv::Scalar(1, 2, 3));
+
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < frames; i++)
+            probe.set_data(image);
+        const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+        const double seconds = std::chrono::duration<double>(end - start).count();
+        const double megabytes = frames * image.total() * image.elemSize() / 1e6;
+
+        std::cout << size.width << "x" << size.height << "\t" << frames / seconds << "\t" << megabytes / seconds << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#include <Check.h>
+
+#include <RobotsIO/Camera/YarpStereoSynchronizer.h>
+
+#include <cmath>
+#include <string>
+#include <tuple>
+
+#include <yarp/os/BufferedPort.h>
+#include <yarp/os/Network.h>
+#include <yarp/os/Stamp.h>
+#include <yarp/sig/Image.h>
+
+using namespace RobotsIO::Camera;
+using namespace yarp::os;
+using namespace yarp::sig;
+
+
+namespace
+{
+    /**
+     * Publishes a small image, filled with the given value in the red channel, stamped with the given timestamp.
+     */
+    void publish(BufferedPort<ImageOf<PixelRgb>>& port, const unsigned char& value, const double& timestamp)
+    {
+        ImageOf<PixelRgb>& image = port.prepare();
+        image.resize(8, 6);
+        for (std::size_t v = 0; v < image.height(); v++)
+            for (std::size_t u = 0; u < image.width(); u++)
+            {
+                image.pixel(u, v).r = value;
+                image.pixel(u, v).g = 0;
+                image.pixel(u, v).b = 0;
+            }
+
+        Stamp stamp(static_cast<int>(value), timestamp);
+        port.setEnvelope(stamp);
+        port.writeStrict();
+    }
+
+
+    /**
+     * The value published in the red channel, i.e. the last channel of the BGR image.
+     */
+    int value_of(const cv::Mat& image)
+    {
+        return image.at<cv::Vec3b>(0, 0)[2];
+    }
+}
+
+
+int main()
+{
+    /* Fake image publishers and the synchronizer share a name server local to the process. */
+    Network::setLocalMode(true);
+    Network yarp;
+
+    const double tolerance = 0.005;
+    YarpStereoSynchronizer synchronizer("robots-io-test", tolerance, 4);
+
+    BufferedPort<ImageOf<PixelRgb>> left;
+    BufferedPort<ImageOf<PixelRgb>> right;
+    ROBOTSIO_CHECK(left.open("/robots-io-test/left:o"));
+    ROBOTSIO_CHECK(right.open("/robots-io-test/right:o"));
+    ROBOTSIO_CHECK(Network::connect("/robots-io-test/left:o", "/robots-io-test/left/rgbImage:i"));
+    ROBOTSIO_CHECK(Network::connect("/robots-io-test/right:o", "/robots-io-test/right/rgbImage:i"));
+
+    /* A pair within the tolerance. */
+    publish(left, 1, 1.0);
+    publish(right, 1, 1.002);
+
+    bool valid_pair = false;
+    YarpStereoSynchronizer::StereoPair first;
+    std::tie(valid_pair, first) = synchronizer.pair(true);
+    ROBOTSIO_CHECK(valid_pair);
+    ROBOTSIO_CHECK(value_of(first.left) == 1);
+    ROBOTSIO_CHECK(value_of(first.right) == 1);
+    ROBOTSIO_CHECK(first.left_timestamp == 1.0);
+    ROBOTSIO_CHECK(first.right_timestamp == 1.002);
+
+    /* The right image out of the tolerance is skipped in favour of the following one. */
+    publish(left, 2, 2.0);
+    publish(right, 9, 2.5);
+    publish(right, 2, 2.001);
+
+    YarpStereoSynchronizer::StereoPair second;
+    std::tie(valid_pair, second) = synchronizer.pair(true);
+    ROBOTSIO_CHECK(valid_pair);
+    ROBOTSIO_CHECK(value_of(second.left) == 2);
+    ROBOTSIO_CHECK(value_of(second.right) == 2);
+    ROBOTSIO_CHECK(std::abs(second.left_timestamp - second.right_timestamp) <= tolerance);
+
+    /* Pairs already delivered are not overwritten by the following ones. */
+    ROBOTSIO_CHECK(value_of(first.left) == 1);
+    ROBOTSIO_CHECK(value_of(first.right) == 1);
+    ROBOTSIO_CHECK(first.left.data != second.left.data);
+    ROBOTSIO_CHECK(first.right.data != second.right.data);
+
+    /* Nothing is left to be paired. */
+    std::tie(valid_pair, std::ignore) = synchronizer.pair(false);
+    ROBOTSIO_CHECK(!valid_pair);
+
+    const YarpStereoSynchronizer::Statistics statistics = synchronizer.statistics();
+    ROBOTSIO_CHECK(statistics.pairs == 2);
+    ROBOTSIO_CHECK(statistics.dropped_left == 0);
+    ROBOTSIO_CHECK(statistics.dropped_right == 1);
+    ROBOTSIO_CHECK(std::abs(statistics.last_skew - 0.001) < 1e-9);
+
+    left.close();
+    right.close();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#include <Check.h>
+
+#include <RobotsIO/Utils/YarpBatchedVectorOfProbe.hpp>
+#include <RobotsIO/Utils/YarpVectorOfBatch.h>
+
+#include <Eigen/Dense>
+
+#include <cstdlib>
+#include <initializer_list>
+#include <limits>
+
+#include <yarp/os/BufferedPort.h>
+#include <yarp/os/Network.h>
+#include <yarp/sig/Vector.h>
+
+using namespace Eigen;
+using namespace RobotsIO::Utils;
+using namespace yarp::os;
+using namespace yarp::sig;
+
+
+namespace
+{
+    VectorOf<double> make_batch(const std::initializer_list<double>& values)
+    {
+        VectorOf<double> batch(values.size());
+
+        std::size_t i = 0;
+        for (const double& value : values)
+            batch[i++] = value;
+
+        return batch;
+    }
+
+
+    bool unpack(const VectorOf<double>& batch)
+    {
+        VectorXd timestamps;
+        MatrixXd samples;
+
+        return unpack_vector_of_batch(batch, timestamps, samples);
+    }
+}
+
+
+int main()
+{
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const double infinity = std::numeric_limits<double>::infinity();
+
+    /* Valid batches. */
+    {
+        VectorXd timestamps;
+        MatrixXd samples;
+
+        ROBOTSIO_CHECK(unpack_vector_of_batch(make_batch({2, 1, 0.5, 10, 0.6, 20}), timestamps, samples));
+        ROBOTSIO_CHECK(timestamps.size() == 2);
+        ROBOTSIO_CHECK((timestamps(0) == 0.5) && (timestamps(1) == 0.6));
+        ROBOTSIO_CHECK((samples.rows() == 1) && (samples.cols() == 2));
+        ROBOTSIO_CHECK((samples(0, 0) == 10) && (samples(0, 1) == 20));
+
+        ROBOTSIO_CHECK(unpack_vector_of_batch(make_batch({0, 3}), timestamps, samples));
+        ROBOTSIO_CHECK(timestamps.size() == 0);
+        ROBOTSIO_CHECK(samples.cols() == 0);
+    }
+
+    /* Malformed headers and sizes, including values whose conversion or product would not be representable. */
+    ROBOTSIO_CHECK(!unpack(make_batch({})));
+    ROBOTSIO_CHECK(!unpack(make_batch({1})));
+    ROBOTSIO_CHECK(!unpack(make_batch({nan, 1, 0.5, 10})));
+    ROBOTSIO_CHECK(!unpack(make_batch({1, nan, 0.5, 10})));
+    ROBOTSIO_CHECK(!unpack(make_batch({infinity, 1, 0.5, 10})));
+    ROBOTSIO_CHECK(!unpack(make_batch({-1, 1, 0.5, 10})));
+    ROBOTSIO_CHECK(!unpack(make_batch({1.5, 1, 0.5, 10})));
+    ROBOTSIO_CHECK(!unpack(make_batch({1, 0.5, 0.5, 10})));
+    ROBOTSIO_CHECK(!unpack(make_batch({1e300, 1e300, 0.5, 10})));
+    ROBOTSIO_CHECK(!unpack(make_batch({4294967296.0, 1, 0.5, 10})));
+    ROBOTSIO_CHECK(!unpack(make_batch({4294967295.0, 4294967295.0, 0.5, 10})));
+    ROBOTSIO_CHECK(!unpack(make_batch({0, 1, 0.5, 10})));
+    ROBOTSIO_CHECK(!unpack(make_batch({2, 1, 0.5, 10})));
+
+    /* Loopback through a name server local to the process. */
+    {
+        Network::setLocalMode(true);
+        Network yarp;
+
+        BufferedPort<VectorOf<double>> reader;
+        ROBOTSIO_CHECK(reader.open("/robots-io-test/batch:i"));
+
+        YarpBatchedVectorOfProbe<VectorXd> probe("/robots-io-test/batch:o", 3, 1000.0);
+        ROBOTSIO_CHECK(Network::connect("/robots-io-test/batch:o", "/robots-io-test/batch:i"));
+
+        /* The batch is sent once it is full. */
+        for (std::size_t i = 0; i < 3; i++)
+            probe.set_data(VectorXd(VectorXd::Constant(4, static_cast<double>(i))));
+
+        VectorOf<double>* batch = reader.read(true);
+        ROBOTSIO_CHECK(batch != nullptr);
+
+        VectorXd timestamps;
+        MatrixXd samples;
+        ROBOTSIO_CHECK(unpack_vector_of_batch(*batch, timestamps, samples));
+        ROBOTSIO_CHECK(timestamps.size() == 3);
+        ROBOTSIO_CHECK((timestamps(0) <= timestamps(1)) && (timestamps(1) <= timestamps(2)));
+        ROBOTSIO_CHECK((samples.rows() == 4) && (samples.cols() == 3));
+        for (std::size_t i = 0; i < 3; i++)
+            ROBOTSIO_CHECK((samples.col(i).array() == static_cast<double>(i)).all());
+    }
+
+    return EXIT_SUCCESS;
+}
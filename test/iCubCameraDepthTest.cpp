@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#include <Check.h>
+
+#include <RobotsIO/Camera/iCubCameraDepth.h>
+
+#include <Eigen/Dense>
+
+#include <opencv2/opencv.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <string>
+
+#include <sys/stat.h>
+
+using namespace Eigen;
+using namespace RobotsIO::Camera;
+
+/**
+ * Stereo depth of an offline iCubCameraDepth, playing back a synthetic textured plane.
+ *
+ * Images are written again, with a different red channel, while the camera is in use, such that the test can tell
+ * from which stereo frame the colors of the point cloud and of the frame come from.
+ */
+
+namespace
+{
+    const int width = 320;
+
+    const int height = 240;
+
+    const double focal_length = 300.0;
+
+    const double baseline = 0.1;
+
+    const int disparity = 16;
+
+    /* Depth of the plane for the given disparity. */
+    const double plane_depth = focal_length * baseline / disparity;
+
+
+    bool write_data(const std::string& path, const double& x)
+    {
+        /* Frame index, position and axis-angle of the camera. */
+        std::ofstream data(path + "data.txt");
+        data << "0 " << x << " 0 0 0 0 1 0" << std::endl;
+
+        return data.good();
+    }
+
+
+    /* Writes the stereo pair, the right image being the left one shifted by the disparity. */
+    bool write_images(const std::string& path_left, const std::string& path_right, const unsigned char& red)
+    {
+        std::mt19937 generator(0);
+        std::uniform_int_distribution<int> distribution(0, 255);
+
+        MatrixXi texture(height, 2 * (width + disparity));
+        for (int i = 0; i < texture.size(); i++)
+            texture(i) = distribution(generator);
+
+        cv::Mat left(height, width, CV_8UC3);
+        cv::Mat right(height, width, CV_8UC3);
+        for (int v = 0; v < height; v++)
+            for (int u = 0; u < width; u++)
+            {
+                cv::Vec3b& pixel_left = left.at<cv::Vec3b>(v, u);
+                pixel_left[0] = static_cast<unsigned char>(texture(v, 2 * u));
+                pixel_left[1] = static_cast<unsigned char>(texture(v, 2 * u + 1));
+                pixel_left[2] = red;
+
+                cv::Vec3b& pixel_right = right.at<cv::Vec3b>(v, u);
+                pixel_right[0] = static_cast<unsigned char>(texture(v, 2 * (u + disparity)));
+                pixel_right[1] = static_cast<unsigned char>(texture(v, 2 * (u + disparity) + 1));
+                pixel_right[2] = red;
+            }
+
+        return cv::imwrite(path_left + "rgb_0.png", left) && cv::imwrite(path_right + "rgb_0.png", right);
+    }
+
+
+    void remove_dataset(const std::string& path, const std::string& path_left, const std::string& path_right)
+    {
+        for (const std::string& camera_path : {path_left, path_right})
+        {
+            std::remove((camera_path + "rgb_0.png").c_str());
+            std::remove((camera_path + "data.txt").c_str());
+            std::remove(camera_path.c_str());
+        }
+        std::remove(path.c_str());
+    }
+
+
+    bool has_red(const cv::Mat& image, const unsigned char& red)
+    {
+        if ((image.rows != height) || (image.cols != width))
+            return false;
+
+        for (int v = 0; v < height; v++)
+            for (int u = 0; u < width; u++)
+                if (image.at<cv::Vec3b>(v, u)[2] != red)
+                    return false;
+
+        return true;
+    }
+
+
+    /* Whether the depths are equal, including the invalid values. */
+    bool is_same_depth(const MatrixXf& a, const MatrixXf& b)
+    {
+        if ((a.rows() != b.rows()) || (a.cols() != b.cols()))
+            return false;
+
+        return ((a.array() == b.array()) || (a.array().isNaN() && b.array().isNaN())).all();
+    }
+
+
+    /* Whether all the points have the given red channel and most of them lie on the plane. */
+    bool is_plane(const MatrixXd& cloud, const unsigned char& red)
+    {
+        if ((cloud.rows() != 6) || (cloud.cols() < (width * height) / 2))
+            return false;
+
+        if ((cloud.row(3).array() != red).any())
+            return false;
+
+        const double on_plane = ((cloud.row(2).array() - plane_depth).abs() < 0.05 * plane_depth).cast<double>().sum();
+
+        return on_plane > 0.9 * cloud.cols();
+    }
+
+
+    int check_camera(const std::string& path_left, const std::string& path_right)
+    {
+        iCubCameraDepth camera(path_left, path_right, width, height, focal_length, width / 2.0, focal_length, height / 2.0, focal_length, width / 2.0, focal_length, height / 2.0, false);
+        camera.step_frame();
+
+        bool valid_depth = false;
+        MatrixXf depth;
+        std::tie(valid_depth, depth) = camera.depth(true);
+        ROBOTSIO_CHECK(valid_depth);
+
+        /* The point cloud takes the colors from the stereo frame its depth is evaluated from, not from the one of the previous depth(). */
+        ROBOTSIO_CHECK(write_images(path_left, path_right, 200));
+
+        bool valid_cloud = false;
+        MatrixXd cloud;
+        std::tie(valid_cloud, cloud) = camera.point_cloud(true, 10.0, false, true);
+        ROBOTSIO_CHECK(valid_cloud);
+        ROBOTSIO_CHECK(is_plane(cloud, 200));
+
+        /* Likewise, the frame takes all the data from a single stereo frame. */
+        std::tie(valid_depth, depth) = camera.depth(true);
+        ROBOTSIO_CHECK(valid_depth);
+        ROBOTSIO_CHECK(write_images(path_left, path_right, 60));
+
+        bool valid_frame = false;
+        Camera::Frame frame;
+        std::tie(valid_frame, frame) = camera.frame(true);
+        ROBOTSIO_CHECK(valid_frame);
+        ROBOTSIO_CHECK(has_red(frame.rgb, 60));
+        ROBOTSIO_CHECK((frame.depth.rows() == height) && (frame.depth.cols() == width));
+
+        /* The confidence map is evaluated from the disparity the depth of the same stereo frame is evaluated from. */
+        std::tie(valid_depth, depth) = camera.depth(true);
+        ROBOTSIO_CHECK(valid_depth);
+
+        bool valid_confidence = false;
+        MatrixXf depth_confidence;
+        MatrixXf confidence;
+        std::tie(valid_confidence, depth_confidence, confidence) = camera.depth_with_confidence(true);
+        ROBOTSIO_CHECK(valid_confidence);
+        ROBOTSIO_CHECK(is_same_depth(depth, depth_confidence));
+        ROBOTSIO_CHECK((confidence.rows() == height) && (confidence.cols() == width));
+
+        const double number_reliable = confidence.sum();
+        const double number_reliable_on_plane = ((confidence.array() > 0) && ((depth.array() - plane_depth).abs() < 0.05 * plane_depth)).cast<double>().sum();
+        ROBOTSIO_CHECK(number_reliable > (width * height) / 2);
+        ROBOTSIO_CHECK(number_reliable_on_plane > 0.95 * number_reliable);
+
+        return EXIT_SUCCESS;
+    }
+}
+
+
+int main()
+{
+    char path_template[] = "/tmp/robots-io-test-XXXXXX";
+    if (mkdtemp(path_template) == nullptr)
+        return EXIT_FAILURE;
+
+    const std::string path = std::string(path_template) + "/";
+    const std::string path_left = path + "left/";
+    const std::string path_right = path + "right/";
+    mkdir(path_left.c_str(), 0700);
+    mkdir(path_right.c_str(), 0700);
+
+    /* The right camera is displaced along the x axis of the left one. */
+    ROBOTSIO_CHECK(write_data(path_left, 0.0));
+    ROBOTSIO_CHECK(write_data(path_right, baseline));
+    ROBOTSIO_CHECK(write_images(path_left, path_right, 10));
+
+    const int result = check_camera(path_left, path_right);
+
+    remove_dataset(path, path_left, path_right);
+
+    return result;
+}
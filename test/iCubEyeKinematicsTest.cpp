@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2019 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This software may be modified and distributed under the terms of the
+ * GPL-2+ license. See the accompanying LICENSE file for details.
+ */
+
+#include <Check.h>
+
+#include <RobotsIO/Camera/iCubEyeKinematics.h>
+
+#include <Eigen/Dense>
+
+#include <cmath>
+#include <random>
+#include <string>
+
+#include <iCub/iKin/iKinFwd.h>
+
+#include <yarp/eigen/Eigen.h>
+#include <yarp/sig/Vector.h>
+
+using namespace Eigen;
+using namespace RobotsIO::Camera;
+using namespace iCub::iKin;
+using namespace yarp::eigen;
+
+
+namespace
+{
+    /**
+     * Pose of the eye as evaluated by iKin, configured as iCubCamera used to, i.e. torso released and no joint limits.
+     */
+    Transform<double, 3, Affine> ikin_pose(iCubEye& eye, const iCubEyeKinematics::Joints& joints)
+    {
+        yarp::sig::Vector q(iCubEyeKinematics::number_of_links);
+        toEigen(q) = joints;
+
+        const yarp::sig::Vector pose = eye.EndEffPose(q);
+
+        Transform<double, 3, Affine> transform(Translation<double, 3>(pose(0), pose(1), pose(2)));
+        transform.rotate(AngleAxisd(pose(6), Vector3d(pose(3), pose(4), pose(5))));
+
+        return transform;
+    }
+
+
+    double distance(const Transform<double, 3, Affine>& a, const Transform<double, 3, Affine>& b)
+    {
+        return (a.matrix() - b.matrix()).cwiseAbs().maxCoeff();
+    }
+}
+
+
+int main()
+{
+    const double tolerance = 1e-9;
+    const std::size_t number_of_configurations = 1000;
+
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<double> angle(-40.0, 40.0);
+
+    for (const std::string type : {"left_v2", "right_v2"})
+    {
+        iCubEye eye(type);
+        eye.setAllConstraints(false);
+        eye.releaseLink(0);
+        eye.releaseLink(1);
+        eye.releaseLink(2);
+
+        iCubEyeKinematics kinematics(type);
+
+        /* Encoders, one configuration per column, as stored in the offline data. */
+        MatrixXd encoders(9, number_of_configurations);
+        for (std::size_t i = 0; i < number_of_configurations; i++)
+            for (std::size_t j = 0; j < 9; j++)
+                encoders(j, i) = angle(generator);
+
+        const iCubEyeKinematics::Poses poses = kinematics.poses_from_encoders(encoders);
+        ROBOTSIO_CHECK(poses.size() == number_of_configurations);
+
+        for (std::size_t i = 0; i < number_of_configurations; i++)
+        {
+            const Vector3d torso = encoders.col(i).head<3>();
+            const Matrix<double, 6, 1> head = encoders.col(i).tail<6>();
+
+            /* Chain joints as built by iCubCamera before the fixed-size kinematics. */
+            iCubEyeKinematics::Joints joints;
+            joints << torso(2), torso(1), torso(0), head(0), head(1), head(2), head(3),
+                      (type == "left_v2") ? head(4) + head(5) / 2.0 : head(4) - head(5) / 2.0;
+            joints *= M_PI / 180.0;
+
+            ROBOTSIO_CHECK((kinematics.joints_from_encoders(torso, head) - joints).cwiseAbs().maxCoeff() < tolerance);
+
+            const Transform<double, 3, Affine> expected = ikin_pose(eye, joints);
+            ROBOTSIO_CHECK(distance(kinematics.pose(joints), expected) < tolerance);
+            ROBOTSIO_CHECK(distance(kinematics.pose_from_encoders(torso, head), expected) < tolerance);
+            ROBOTSIO_CHECK(distance(poses[i], expected) < tolerance);
+        }
+    }
+
+    return EXIT_SUCCESS;
+}